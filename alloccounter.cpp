@@ -0,0 +1,50 @@
+#include "alloccounter.h"
+
+#if defined(COUNT_ALLOCATIONS)
+// STL
+#include <new>
+
+// C
+#include <cstdlib>
+
+static thread_local uint64_t allocations = 0;
+
+uint64_t allocation_count(void) noexcept
+{
+  return allocations;
+}
+
+void* operator new(std::size_t size)
+{
+  ++allocations;
+  if(void* pointer = std::malloc(size ? size : 1); pointer)
+    return pointer;
+  throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+  return operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+  ++allocations;
+  return std::malloc(size ? size : 1);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t& tag) noexcept
+{
+  return operator new(size, tag);
+}
+
+void operator delete(void* pointer) noexcept { std::free(pointer); }
+void operator delete[](void* pointer) noexcept { std::free(pointer); }
+void operator delete(void* pointer, std::size_t) noexcept { std::free(pointer); }
+void operator delete[](void* pointer, std::size_t) noexcept { std::free(pointer); }
+#else
+uint64_t allocation_count(void) noexcept
+{
+  return 0;
+}
+#endif
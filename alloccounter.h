@@ -0,0 +1,10 @@
+#ifndef ALLOCCOUNTER_H
+#define ALLOCCOUNTER_H
+
+#include <cstdint>
+
+// calls into the global allocator made by the current thread
+// only counted when built with COUNT_ALLOCATIONS, otherwise always zero
+uint64_t allocation_count(void) noexcept;
+
+#endif // ALLOCCOUNTER_H
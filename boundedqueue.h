@@ -0,0 +1,182 @@
+#ifndef BOUNDEDQUEUE_H
+#define BOUNDEDQUEUE_H
+
+#include <atomic>
+#include <optional>
+#include <memory>
+#include <chrono>
+#include <thread>
+#include <initializer_list>
+
+#include <cstdint>
+#include <cstddef>
+
+// adds the lifetime of the scope to a microsecond counter
+class stage_timer
+{
+public:
+  stage_timer(std::atomic<uint64_t>& counter) noexcept
+    : m_counter(counter), m_start(std::chrono::steady_clock::now()) { }
+  ~stage_timer(void) noexcept
+    { m_counter += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - m_start).count(); }
+
+private:
+  std::atomic<uint64_t>& m_counter;
+  std::chrono::steady_clock::time_point m_start;
+};
+
+// lock-free multi-producer/multi-consumer ring (Dmitry Vyukov's bounded queue)
+// with blocking wrappers that provide backpressure between pipeline stages,
+// a blocked side spins briefly and then sleeps until the other side moves
+template<typename T>
+class bounded_queue
+{
+public:
+  bounded_queue(std::size_t capacity)
+  {
+    std::size_t size = 2;
+    while(size < capacity)
+      size <<= 1;
+    m_mask = size - 1;
+    m_buffer = std::make_unique<cell_t[]>(size);
+    for(std::size_t i = 0; i < size; ++i)
+      m_buffer[i].sequence.store(i, std::memory_order_relaxed);
+  }
+
+  bool try_push(T& value)
+  {
+    cell_t* cell;
+    std::size_t pos = m_enqueue_pos.load(std::memory_order_relaxed);
+    for(;;)
+    {
+      cell = &m_buffer[pos & m_mask];
+      intptr_t diff = intptr_t(cell->sequence.load(std::memory_order_acquire)) - intptr_t(pos);
+      if(!diff)
+      {
+        if(m_enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+          break;
+      }
+      else if(diff < 0)
+        return false; // full
+      else
+        pos = m_enqueue_pos.load(std::memory_order_relaxed);
+    }
+    cell->data = std::move(value);
+    cell->sequence.store(pos + 1, std::memory_order_release);
+    wake(m_pushes, m_pop_waiters);
+    return true;
+  }
+
+  bool try_pop(T& value)
+  {
+    cell_t* cell;
+    std::size_t pos = m_dequeue_pos.load(std::memory_order_relaxed);
+    for(;;)
+    {
+      cell = &m_buffer[pos & m_mask];
+      intptr_t diff = intptr_t(cell->sequence.load(std::memory_order_acquire)) - intptr_t(pos + 1);
+      if(!diff)
+      {
+        if(m_dequeue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+          break;
+      }
+      else if(diff < 0)
+        return false; // empty
+      else
+        pos = m_dequeue_pos.load(std::memory_order_relaxed);
+    }
+    value = std::move(cell->data);
+    cell->sequence.store(pos + m_mask + 1, std::memory_order_release);
+    wake(m_pops, m_push_waiters);
+    return true;
+  }
+
+  // blocks while full, returns false if the queue was closed
+  bool push(T&& value, std::atomic<uint64_t>* blocked_us = nullptr)
+  {
+    if(try_push(value))
+      return true;
+    std::optional<stage_timer> timer;
+    if(blocked_us)
+      timer.emplace(*blocked_us);
+    for(int spins = 0; !m_closed.load(std::memory_order_acquire); ++spins)
+    {
+      if(spins < max_spins ? try_push(value) : park(m_pops, m_push_waiters, [&] { return try_push(value); }))
+        return true;
+      if(spins < max_spins)
+        std::this_thread::yield();
+    }
+    return false;
+  }
+
+  // blocks while empty, returns false once the queue is closed and drained
+  bool pop(T& value, std::atomic<uint64_t>* starved_us = nullptr)
+  {
+    if(try_pop(value))
+      return true;
+    std::optional<stage_timer> timer;
+    if(starved_us)
+      timer.emplace(*starved_us);
+    for(int spins = 0;; ++spins)
+    {
+      if(spins < max_spins ? try_pop(value) : park(m_pushes, m_pop_waiters, [&] { return try_pop(value); }))
+        return true;
+      if(m_closed.load(std::memory_order_acquire))
+        return try_pop(value);
+      if(spins < max_spins)
+        std::this_thread::yield();
+    }
+  }
+
+  void close(void) noexcept
+  {
+    m_closed.store(true, std::memory_order_release);
+    for(std::atomic<uint32_t>* counter : { &m_pushes, &m_pops })
+    {
+      counter->fetch_add(1, std::memory_order_release);
+      counter->notify_all();
+    }
+  }
+
+private:
+  static constexpr int max_spins = 64;
+
+  // the waiter registers before it reads the counter and makes its last attempt,
+  // so a wake() that finds no waiter has already moved the counter past what it read
+  template<typename Attempt>
+  bool park(std::atomic<uint32_t>& counter, std::atomic<uint32_t>& waiters, Attempt attempt)
+  {
+    waiters.fetch_add(1);
+    uint32_t seen = counter.load();
+    bool done = attempt();
+    if(!done && !m_closed.load(std::memory_order_acquire))
+      counter.wait(seen);
+    waiters.fetch_sub(1, std::memory_order_relaxed);
+    return done;
+  }
+
+  static void wake(std::atomic<uint32_t>& counter, std::atomic<uint32_t>& waiters) noexcept
+  {
+    counter.fetch_add(1);
+    if(waiters.load())
+      counter.notify_one();
+  }
+
+  struct cell_t
+  {
+    std::atomic<std::size_t> sequence;
+    T data;
+  };
+
+  std::unique_ptr<cell_t[]> m_buffer;
+  std::size_t m_mask;
+  alignas(64) std::atomic<std::size_t> m_enqueue_pos = 0;
+  alignas(64) std::atomic<std::size_t> m_dequeue_pos = 0;
+  alignas(64) std::atomic<bool> m_closed = false;
+  alignas(64) std::atomic<uint32_t> m_pushes = 0; // consumers sleep on this
+  std::atomic<uint32_t> m_pop_waiters = 0;
+  alignas(64) std::atomic<uint32_t> m_pops = 0; // producers sleep on this
+  std::atomic<uint32_t> m_push_waiters = 0;
+};
+
+#endif // BOUNDEDQUEUE_H
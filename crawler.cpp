@@ -0,0 +1,422 @@
+#include "crawler.h"
+
+// STL
+#include <iostream>
+#include <iomanip>
+#include <thread>
+#include <chrono>
+
+// project
+#include <scrapers/utilities.h>
+#include "alloccounter.h"
+
+Crawler::Crawler(std::string_view name, const ScraperBase* scraper, DBInterface& db, const crawl_options_t& options)
+  : m_name(name),
+    m_scraper(scraper),
+    m_db(db),
+    m_options(options),
+    m_engine(name, options.max_transfers, options.max_host_transfers, options.cache,
+             [this](const pair_data_t& data, std::string_view element) { element_received(data, element); }),
+    m_main_queue(options.schedule),
+    m_fetched(options.queue_depth)
+{
+}
+
+void Crawler::start(store_queue_t& store_queue)
+{
+  m_stored = &store_queue;
+  m_start = std::chrono::steady_clock::now();
+  {
+    pair_data_t nd;
+    nd.query.parser = Parser::BuildQuery | Parser::Initial;
+    nd.query.node_id = "root";
+    schedule(std::move(nd));
+  }
+
+  auto guarded = [this](void (Crawler::*stage)(void))
+  {
+    try { (this->*stage)(); }
+    catch(...) { fail(std::current_exception()); }
+  };
+
+  m_threads.emplace_back(guarded, &Crawler::fetch_stage);
+  for(std::size_t i = 0; i < std::max<std::size_t>(m_options.parser_threads, 1); ++i)
+    m_threads.emplace_back(guarded, &Crawler::parse_stage);
+}
+
+std::exception_ptr Crawler::join(void)
+{
+  for(auto& thread : m_threads)
+    thread.join();
+  m_threads.clear();
+
+  report(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - m_start).count());
+  return m_error;
+}
+
+bool Crawler::store(parsed_t& parsed)
+{
+  {
+    stage_timer timer(m_store_stats.busy_us);
+    uint64_t allocations = allocation_count();
+    uint64_t copies = record_copy_count();
+    dispatch(parsed.results);
+    if(parsed.fetched != Parser::Discard)
+      m_db.addFetchedNode(m_name, parsed.fetched, parsed.node_id);
+    m_store_stats.allocations += allocation_count() - allocations;
+    m_store_stats.copies += record_copy_count() - copies;
+  }
+  ++m_store_stats.items;
+  return !--m_outstanding; // nothing left anywhere in the pipeline
+}
+
+void Crawler::schedule(pair_data_t&& data)
+{
+  {
+    std::lock_guard<std::mutex> lock(m_queue_mutex);
+    m_main_queue.push(std::move(data));
+    ++m_outstanding;
+  }
+  m_queue_cv.notify_one();
+  m_engine.wakeup();
+}
+
+// called from inside the transfer, each element is parsed and stored on its own
+void Crawler::element_received(const pair_data_t& data, std::string_view element)
+{
+  ++m_outstanding; // the transfer's own completion still follows
+  if(!m_fetched.push({ data, std::string(element), true, true }, &m_fetch_stats.blocked_us))
+    --m_outstanding; // stopped, the writer will never see it
+}
+
+void Crawler::stop(void)
+{
+  {
+    std::lock_guard<std::mutex> lock(m_queue_mutex);
+    m_done = true;
+  }
+  m_fetched.close();
+  m_queue_cv.notify_all();
+  m_engine.wakeup();
+}
+
+void Crawler::fail(std::exception_ptr error)
+{
+  {
+    std::lock_guard<std::mutex> lock(m_error_mutex);
+    if(!m_error)
+      m_error = error;
+  }
+  stop();
+  m_stored->close(); // irrecoverable, halt every crawler sharing the writer
+}
+
+void Crawler::fetch_stage(void)
+{
+  std::vector<pair_data_t> batch;
+  while(!m_done)
+  {
+    batch.clear();
+    {
+      std::unique_lock<std::mutex> lock(m_queue_mutex);
+      if(m_engine.idle() && m_main_queue.empty())
+      {
+        stage_timer timer(m_fetch_stats.starved_us);
+        m_queue_cv.wait(lock, [this] { return !m_main_queue.empty() || m_done; });
+      }
+
+      std::size_t count = std::min(m_engine.capacity(), m_main_queue.size());
+      if(count)
+        std::cout << "queue size: " << m_main_queue.size() << std::endl;
+      while(batch.size() < count)
+        batch.push_back(m_main_queue.take());
+    }
+
+    for(auto& pos : batch)
+    {
+      if((pos.query.parser & Parser::BuildQuery) == Parser::BuildQuery)
+        pos = m_scraper->BuildQuery(std::move(pos));
+
+      if(pos.query.parser == Parser::Initial) // nothing to download
+      {
+        if(!m_fetched.push({ std::move(pos), std::string(), true }, &m_fetch_stats.blocked_us))
+          return;
+      }
+      else
+      {
+        bool stream = m_scraper->StreamsElements(pos);
+        m_engine.queue(std::move(pos), stream);
+      }
+    }
+
+    if(!m_engine.idle())
+    {
+      std::vector<fetch_result_t> completed;
+      {
+        stage_timer timer(m_fetch_stats.busy_us);
+        completed = m_engine.wait();
+      }
+      for(auto& result : completed)
+      {
+        ++m_fetch_stats.items;
+        bool parse = result.status != fetch_status_t::missing &&
+                     result.status != fetch_status_t::failed &&
+                     result.status != fetch_status_t::streamed &&
+                     (result.status != fetch_status_t::not_modified || !m_options.skip_unchanged);
+        if(!m_fetched.push({ std::move(result.data), std::move(result.body), parse }, &m_fetch_stats.blocked_us))
+          return;
+      }
+    }
+    m_fetch_stats.copies = record_copy_count(); // this thread only ever runs the fetch stage
+  }
+}
+
+void Crawler::parse_stage(void)
+{
+  fetched_t item;
+  while(m_fetched.pop(item, &m_parse_stats.starved_us))
+  {
+    std::vector<pair_data_t> results;
+    if(item.parse) // an empty result still tells the writer this record is done
+    {
+      stage_timer timer(m_parse_stats.busy_us);
+      uint64_t allocations = allocation_count();
+      uint64_t copies = record_copy_count();
+      if(item.element)
+        results = m_scraper->ParseElement(item.data, item.body);
+      else
+        results = m_scraper->Parse(item.data, item.body);
+      m_parse_stats.allocations += allocation_count() - allocations;
+      m_parse_stats.copies += record_copy_count() - copies;
+    }
+    ++m_parse_stats.items;
+
+    parsed_t parsed { this, std::move(results), Parser::Discard, std::string() };
+    if(item.parse && item.data.query.node_id &&
+       (item.data.query.parser == Parser::Station || item.data.query.parser == Parser::Port))
+    {
+      parsed.fetched = item.data.query.parser;
+      parsed.node_id = *item.data.query.node_id;
+    }
+    if(!m_stored->push(std::move(parsed), &m_parse_stats.blocked_us))
+      return;
+  }
+}
+
+void Crawler::dispatch(std::vector<pair_data_t>& results)
+{
+  for(auto& result : results)
+    m_test_queue.push_back(std::move(result));
+  std::cout << "result count: " << m_test_queue.size() << std::endl;
+
+  while(!m_test_queue.empty())
+  {
+    pair_data_t nd = m_test_queue.take_front(); // the queue may grow below
+    switch(nd.query.parser)  // test the data
+    {
+      case Parser::Discard:
+        std::cout << "discarding" << std::endl;
+        break;
+
+      case Parser::Complete:
+        m_completed.push_back(std::move(nd.station)); // written together below
+        break;
+
+      case Parser::ReplaceRecord | Parser::MapArea:
+        m_db.addMapLocation(nd);
+        if(nd.query.covered && nd.station.network_id)
+          m_db.addCoveredArea(*nd.station.network_id, nd.query.bounds);
+        break;
+
+      case Parser::BuildQuery | Parser::MapArea:
+      {
+        bool lookup = false;
+        if(nd.query.bounds)
+        {
+          // an exact repeat of a covered area is inside it too
+          std::optional<pair_data_t> covering;
+          if(nd.station.network_id && m_db.isCoveredArea(*nd.station.network_id, nd.query.bounds))
+            covering = m_db.getCoveringMapLocation(*nd.station.network_id, nd.query.bounds);
+          if(covering)
+          {
+            // not requested again, the stations of the cached listing go through the
+            // fresh node check so those an interrupted run or a failed fetch never stored are fetched
+            ++m_redundant_count;
+            if(covering->query.child_ids)
+            {
+              for(auto& node_id : ext::to_list(*covering->query.child_ids))
+              {
+                if(node_id.empty())
+                  continue;
+                pair_data_t tmp;
+                tmp.query.parser = Parser::BuildQuery | Parser::Station; // a covered listing holds no clusters
+                tmp.query.node_id = node_id;
+                tmp.station.network_id = covering->station.network_id;
+                m_test_queue.push_back(std::move(tmp));
+              }
+            }
+            break;
+          }
+          if(m_db.identifyMapLocation(nd)) // answered before, classify() needs the cached children
+          {
+            if(auto locdata = m_db.getMapLocation(*nd.station.network_id, *nd.query.node_id); locdata)
+            {
+              nd = std::move(*locdata);
+              lookup = true;
+            }
+          }
+        }
+        else if(auto locdata = m_db.getMapLocation(*nd.station.network_id, *nd.query.node_id); locdata)
+        {
+          nd = std::move(*locdata);
+          lookup = true;
+        }
+
+        if(lookup)
+        {
+          m_scraper->classify(nd); // scraper decides parser this should use
+          if(nd.query.child_ids) // has children
+          {
+            for(auto& node_id : ext::to_list(*nd.query.child_ids))
+            {
+              if(node_id.empty()) // explored and empty
+                continue;
+              pair_data_t tmp;
+              tmp.query.parser = Parser::BuildQuery | Parser::MapArea;
+              tmp.query.node_id = node_id;
+              tmp.station.network_id = nd.station.network_id;
+              m_test_queue.push_back(std::move(tmp)); // queue to be tested
+            }
+          }
+          else // no children
+          {
+            if(nd.query.parser == (Parser::BuildQuery | Parser::MapArea)) // parser didn't change
+              schedule(std::move(nd)); // more data is needed, queue for querying
+            else
+              m_test_queue.push_back(std::move(nd)); // queue to be tested
+          }
+        }
+        else
+        {
+          m_db.addMapLocation(nd);
+          schedule(std::move(nd));
+        }
+        break;
+      }
+
+      case Parser::BuildQuery | Parser::Station:
+        if(const std::string& id = *nd.query.node_id; m_station_nodes.insert(id))
+        {
+          if(m_db.isFreshNode(m_name, Parser::Station, id))
+            ++m_fresh_count; // refreshed recently by an earlier run
+          else
+            schedule(std::move(nd));
+        }
+        break;
+
+      case Parser::BuildQuery | Parser::Port:
+        if(const std::string& id = *nd.query.node_id; m_port_nodes.insert(id))
+        {
+          if(m_db.isFreshNode(m_name, Parser::Port, id))
+            ++m_fresh_count;
+          else
+            schedule(std::move(nd));
+        }
+        break;
+
+      default:
+        schedule(std::move(nd));
+    }
+  }
+
+  if(!m_completed.empty())
+  {
+    m_db.addStations(m_completed);
+    m_insertion_count += m_completed.size();
+    m_completed.clear();
+  }
+}
+
+void Crawler::report(uint64_t wall_us) const
+{
+  auto percent = [wall_us](uint64_t us, std::size_t threads = 1)
+    { return wall_us ? 100.0 * double(us) / double(wall_us * threads) : 0.0; };
+
+  auto print = [&percent](std::string_view stage, const stage_stats_t& stats, std::size_t threads)
+  {
+    std::cout << "  " << std::setw(6) << std::left << stage
+              << std::right << std::setw(8) << stats.items << " items"
+              << std::fixed << std::setprecision(1)
+              << "  busy "    << std::setw(5) << percent(stats.busy_us, threads) << '%'
+              << "  starved " << std::setw(5) << percent(stats.starved_us, threads) << '%'
+              << "  blocked " << std::setw(5) << percent(stats.blocked_us, threads) << '%';
+    if(stats.allocations && stats.items)
+      std::cout << "  " << std::setw(8) << double(stats.allocations) / double(stats.items) << " allocations/item";
+    if(stats.copies && stats.items)
+      std::cout << "  " << std::setw(6) << double(stats.copies) / double(stats.items) << " copies/item";
+    std::cout << std::defaultfloat << std::setprecision(6) << std::endl;
+  };
+
+  std::cout << m_name << " stage utilization over " << double(wall_us) / 1000000.0 << "s:" << std::endl;
+  print("fetch", m_fetch_stats, 1);
+  print("parse", m_parse_stats, std::max<std::size_t>(m_options.parser_threads, 1));
+  print("store", m_store_stats, 1);
+
+  std::cout << "  peak queue " << m_main_queue.peak() << " records, "
+            << m_station_nodes.size() + m_port_nodes.size() << " ids seen in "
+            << (m_station_nodes.memory() + m_port_nodes.memory()) / 1024 << "KiB" << std::endl;
+
+  const fetch_stats_t& transfer = m_engine.stats();
+  std::cout << "  " << transfer.wire_bytes << " bytes on the wire, "
+            << transfer.body_bytes << " decoded in " << transfer.decode_us / 1000 << "ms, "
+            << transfer.failed << " failed" << std::endl;
+}
+
+void crawl(std::list<Crawler>& crawlers, std::size_t queue_depth)
+{
+  store_queue_t store_queue(queue_depth);
+  stage_stats_t writer_stats;
+  auto start = std::chrono::steady_clock::now();
+
+  for(auto& crawler : crawlers)
+    crawler.start(store_queue);
+
+  std::exception_ptr error;
+  try
+  {
+    parsed_t parsed;
+    for(std::size_t remaining = crawlers.size(); remaining && store_queue.pop(parsed, &writer_stats.starved_us);)
+    {
+      stage_timer timer(writer_stats.busy_us);
+      if(parsed.source->store(parsed))
+      {
+        parsed.source->stop();
+        --remaining;
+      }
+    }
+  }
+  catch(...)
+  {
+    error = std::current_exception();
+  }
+
+  store_queue.close();
+  for(auto& crawler : crawlers)
+    crawler.stop();
+  for(auto& crawler : crawlers)
+    if(auto crawler_error = crawler.join(); crawler_error && !error)
+      error = crawler_error;
+
+  if(crawlers.size() > 1)
+  {
+    uint64_t wall_us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "database writer over " << double(wall_us) / 1000000.0 << "s:"
+              << std::fixed << std::setprecision(1)
+              << "  busy "    << 100.0 * double(writer_stats.busy_us) / double(std::max<uint64_t>(wall_us, 1)) << '%'
+              << "  starved " << 100.0 * double(writer_stats.starved_us) / double(std::max<uint64_t>(wall_us, 1)) << '%'
+              << std::defaultfloat << std::setprecision(6) << std::endl;
+  }
+
+  if(error)
+    std::rethrow_exception(error);
+}
@@ -0,0 +1,125 @@
+#ifndef CRAWLER_H
+#define CRAWLER_H
+
+#include <string>
+#include <string_view>
+#include <list>
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <thread>
+#include <chrono>
+
+#include <scrapers/scraper_base.h>
+
+#include "dbinterface.h"
+#include "fetchengine.h"
+#include "responsecache.h"
+#include "boundedqueue.h"
+#include "ringqueue.h"
+#include "workscheduler.h"
+#include "idset.h"
+
+struct crawl_options_t
+{
+  std::size_t max_transfers;
+  std::size_t max_host_transfers;
+  std::size_t parser_threads;
+  std::size_t queue_depth; // capacity of each queue between stages
+  ResponseCache* cache = nullptr;
+  bool skip_unchanged = false; // don't parse pages the server reports as not modified
+  schedule_policy_t schedule = schedule_policy_t::kind; // order in which waiting records are fetched
+};
+
+struct stage_stats_t
+{
+  std::atomic<uint64_t> items = 0;
+  std::atomic<uint64_t> busy_us = 0;
+  std::atomic<uint64_t> starved_us = 0; // waiting on the previous stage
+  std::atomic<uint64_t> blocked_us = 0; // waiting on the next stage
+  std::atomic<uint64_t> allocations = 0; // heap allocations while busy, needs COUNT_ALLOCATIONS
+  std::atomic<uint64_t> copies = 0; // pair_data_t copies, needs COUNT_COPIES
+};
+
+class Crawler;
+
+struct parsed_t
+{
+  Crawler* source = nullptr;
+  std::vector<pair_data_t> results;
+  Parser fetched = Parser::Discard; // Station or Port node recorded as fetched once the results are stored
+  std::string node_id;
+};
+
+using store_queue_t = bounded_queue<parsed_t>;
+
+// crawl context for one scraper: its own queue, duplicate filters and HTTP engine
+// runs as overlapping stages: fetch thread -> parser pool -> shared database writer
+class Crawler
+{
+public:
+  Crawler(std::string_view name, const ScraperBase* scraper, DBInterface& db, const crawl_options_t& options);
+
+  const std::string& name(void) const noexcept { return m_name; }
+  uintptr_t insertions(void) const noexcept { return m_insertion_count; }
+  uintptr_t skipped(void) const noexcept { return m_fresh_count; }
+  uintptr_t redundant(void) const noexcept { return m_redundant_count; } // map areas resolved from covered ones
+
+  void start(store_queue_t& store_queue); // launches the fetch and parser threads
+  bool store(parsed_t& parsed); // database writer only, returns true once the crawl is complete
+  void stop(void);
+  std::exception_ptr join(void); // returns the first stage failure
+
+private:
+  struct fetched_t
+  {
+    pair_data_t data;
+    std::string body;
+    bool parse = true;
+    bool element = false; // body is one element of a streamed array
+  };
+
+  void fetch_stage(void);
+  void parse_stage(void);
+  void dispatch(std::vector<pair_data_t>& results);
+  void schedule(pair_data_t&& data);
+  void element_received(const pair_data_t& data, std::string_view element);
+  void fail(std::exception_ptr error);
+  void report(uint64_t wall_us) const;
+
+  std::string m_name;
+  const ScraperBase* m_scraper;
+  DBInterface& m_db;
+  crawl_options_t m_options;
+  FetchEngine m_engine; // used only by the fetch thread, except for wakeup()
+
+  std::mutex m_queue_mutex;
+  std::condition_variable m_queue_cv;
+  WorkScheduler m_main_queue;
+  std::atomic<std::size_t> m_outstanding = 0; // scheduled records whose results have not been stored yet
+  std::atomic<bool> m_done = false;
+
+  bounded_queue<fetched_t> m_fetched;
+  store_queue_t* m_stored = nullptr;
+  std::vector<std::thread> m_threads;
+  std::chrono::steady_clock::time_point m_start;
+
+  std::mutex m_error_mutex;
+  std::exception_ptr m_error;
+
+  ring_queue<pair_data_t> m_test_queue; // used only by dispatch(), kept to reuse its buffer
+  std::vector<station_t> m_completed; // stations of one dispatch() call, stored in a single batch
+  id_set m_station_nodes, m_port_nodes; // used to avoid duplicate requests
+  uintptr_t m_insertion_count = 0;
+  uintptr_t m_fresh_count = 0;
+  uintptr_t m_redundant_count = 0;
+
+  stage_stats_t m_fetch_stats, m_parse_stats, m_store_stats;
+};
+
+// runs every crawler at the same time while serializing all database access on the calling thread
+void crawl(std::list<Crawler>& crawlers, std::size_t queue_depth);
+
+#endif // CRAWLER_H
@@ -6,6 +6,11 @@
 #include <functional>
 #include <utility>
 #include <vector>
+#include <array>
+#include <map>
+#include <cmath>
+#include <numbers>
+#include <cstring>
 #include <cassert>
 
 // project
@@ -29,20 +34,545 @@ std::optional<std::string> to_optional(const std::string& input)
   return { input };
 }
 
-DBInterface::DBInterface(std::string_view filename)
+// prepared once at construction, then rebound and reset for every call
+constexpr std::string_view sql_select_map_location =
+  "SELECT "
+    "network_id,"
+    "latitude_max,"
+    "latitude_min,"
+    "longitude_max,"
+    "longitude_min,"
+    "node_id,"
+    "child_ids "
+  "FROM "
+    "map_query_cache "
+  "WHERE "
+    "network_id IS ?1 AND "
+    "node_id IS ?2";
+
+constexpr std::string_view sql_insert_map_location =
+  "INSERT OR IGNORE INTO map_query_cache ("
+    "network_id,"
+    "latitude_max,"
+    "latitude_min,"
+    "longitude_max,"
+    "longitude_min,"
+    "node_id,"
+    "child_ids,"
+    "last_update"
+  ") VALUES (?1,?2,?3,?4,?5,?6,?7,CURRENT_TIMESTAMP)";
+
+constexpr std::string_view sql_identify_map_location =
+  "SELECT "
+    "node_id "
+  "FROM "
+    "map_query_cache "
+  "WHERE "
+    "network_id IS ?1 AND "
+    "node_id IS ?2 AND "
+    "latitude_max IS ?3 AND "
+    "latitude_min IS ?4 AND "
+    "longitude_max IS ?5 AND "
+    "longitude_min IS ?6";
+//    "ABS(latitude_max  - latitude_min ) <= ABS(?3 - ?4) AND "
+//    "ABS(longitude_max - longitude_min) <= ABS(?5 - ?6)";
+
+constexpr std::string_view sql_insert_unique_string =
+  "INSERT INTO unique_strings (string) VALUES (?1)";
+
+constexpr std::string_view sql_identify_unique_string =
+  "SELECT string_id FROM unique_strings WHERE string IS ?1";
+
+constexpr std::string_view sql_select_unique_string =
+  "SELECT string FROM unique_strings WHERE string_id IS ?1";
+
+constexpr std::string_view sql_insert_contact =
+  "INSERT OR IGNORE INTO contact ("
+    "street_number,"
+    "street_name,"
+    "city,"
+    "state,"
+    "country,"
+    "postal_code,"
+    "phone_id,"
+    "URL_id"
+  ") VALUES (?1,?2,?3,?4,?5,?6,?7,?8)";
+
+constexpr std::string_view sql_identify_contact =
+  "SELECT "
+    "contact_id "
+  "FROM "
+    "contact "
+  "WHERE "
+    "IFNULL(street_number, X'') = IFNULL(?1, X'') AND "
+    "IFNULL(street_name, X'') = IFNULL(?2, X'') AND "
+    "IFNULL(city, X'') = IFNULL(?3, X'') AND "
+    "IFNULL(state, X'') = IFNULL(?4, X'') AND "
+    "IFNULL(country, X'') = IFNULL(?5, X'') AND "
+    "IFNULL(postal_code, X'') = IFNULL(?6, X'') "
+  "ORDER BY contact_id LIMIT 1";
+
+constexpr std::string_view sql_select_contact =
+  "SELECT "
+    "street_number,"
+    "street_name,"
+    "city,"
+    "state,"
+    "country,"
+    "postal_code,"
+    "phone_id,"
+    "URL_id "
+  "FROM "
+    "contact "
+  "WHERE "
+    "contact_id IS ?1";
+
+constexpr std::string_view sql_insert_price =
+  "INSERT OR IGNORE INTO price ("
+    "text,"
+    "payment,"
+    "currency,"
+    "minimum,"
+    "initial,"
+    "unit,"
+    "per_unit"
+  ") VALUES (?1,?2,?3,?4,?5,?6,?7)";
+
+constexpr std::string_view sql_identify_price =
+  "SELECT "
+    "price_id "
+  "FROM "
+    "price "
+  "WHERE "
+    "IFNULL(text, X'') = IFNULL(?1, X'') AND "
+    "IFNULL(payment, X'') = IFNULL(?2, X'') AND "
+    "IFNULL(currency, X'') = IFNULL(?3, X'') AND "
+    "IFNULL(minimum, X'') = IFNULL(?4, X'') AND "
+    "IFNULL(initial, X'') = IFNULL(?5, X'') AND "
+    "IFNULL(unit, X'') = IFNULL(?6, X'') AND "
+    "IFNULL(per_unit, X'') = IFNULL(?7, X'')";
+
+constexpr std::string_view sql_select_price =
+  "SELECT "
+    "text,"
+    "payment,"
+    "currency,"
+    "minimum,"
+    "initial,"
+    "unit,"
+    "per_unit "
+  "FROM "
+    "price "
+  "WHERE "
+    "price_id IS ?1";
+
+constexpr std::string_view sql_insert_power =
+  "INSERT OR IGNORE INTO power ("
+    "level,"
+    "connector,"
+    "amp,"
+    "kW,"
+    "volt"
+  ") VALUES (?1,?2,?3,?4,?5)";
+
+constexpr std::string_view sql_identify_power =
+  "SELECT "
+    "power_id "
+  "FROM "
+    "power "
+  "WHERE "
+    "level = ?1 AND "
+    "IFNULL(connector, X'') = IFNULL(?2, X'') AND "
+    "IFNULL(amp, X'') = IFNULL(?3, X'') AND "
+    "IFNULL(kW, X'') = IFNULL(?4, X'') AND "
+    "IFNULL(volt, X'') = IFNULL(?5, X'')";
+
+constexpr std::string_view sql_select_power =
+  "SELECT "
+    "level,"
+    "connector,"
+    "amp,"
+    "kW,"
+    "volt "
+  "FROM "
+    "power "
+  "WHERE "
+    "power_id IS ?1";
+
+// upserts only touch rows whose contents changed, so last_update records the last real change
+constexpr std::string_view sql_insert_port =
+  "INSERT INTO ports ("
+    "network_id,"
+    "port_id,"
+    "station_id,"
+    "power_id,"
+    "price_id,"
+    "status,"
+    "display_name"
+  ") VALUES (?1,?2,?3,?4,?5,?6,?7) "
+  "ON CONFLICT (network_id, port_id) DO UPDATE SET "
+    "station_id = excluded.station_id,"
+    "power_id = excluded.power_id,"
+    "price_id = excluded.price_id,"
+    "status = excluded.status,"
+    "display_name = excluded.display_name,"
+    "last_update = CURRENT_TIMESTAMP "
+  "WHERE "
+    "ports.station_id IS NOT excluded.station_id OR "
+    "ports.power_id IS NOT excluded.power_id OR "
+    "ports.price_id IS NOT excluded.price_id OR "
+    "ports.status IS NOT excluded.status OR "
+    "ports.display_name IS NOT excluded.display_name";
+
+constexpr std::string_view sql_select_port =
+  "SELECT "
+    "station_id,"
+    "power_id,"
+    "price_id,"
+    "status,"
+    "display_name "
+  "FROM "
+    "ports "
+  "WHERE "
+    "network_id IS ?1 AND "
+    "port_id IS ?2";
+
+constexpr std::string_view sql_insert_station =
+  "INSERT INTO stations ("
+    "meta_network_ids,"
+    "meta_station_ids,"
+    "network_id,"
+    "station_id,"
+    "latitude,"
+    "longitude,"
+    "name,"
+    "description,"
+    "access_public,"
+    "restrictions,"
+    "contact_id,"
+    "schedule_id,"
+    "port_ids,"
+    "conflicts"
+  ") VALUES (?1,?2,?3,?4,?5,?6,?7,?8,?9,?10,?11,?12,?13,?14) "
+  "ON CONFLICT (latitude, longitude) DO UPDATE SET "
+    "meta_network_ids = excluded.meta_network_ids,"
+    "meta_station_ids = excluded.meta_station_ids,"
+    "network_id = excluded.network_id,"
+    "station_id = excluded.station_id,"
+    "name = excluded.name,"
+    "description = excluded.description,"
+    "access_public = excluded.access_public,"
+    "restrictions = excluded.restrictions,"
+    "contact_id = excluded.contact_id,"
+    "schedule_id = excluded.schedule_id,"
+    "port_ids = excluded.port_ids,"
+    "conflicts = excluded.conflicts,"
+    "last_update = CURRENT_TIMESTAMP "
+  "WHERE "
+    "stations.meta_network_ids IS NOT excluded.meta_network_ids OR "
+    "stations.meta_station_ids IS NOT excluded.meta_station_ids OR "
+    "stations.network_id IS NOT excluded.network_id OR "
+    "stations.station_id IS NOT excluded.station_id OR "
+    "stations.name IS NOT excluded.name OR "
+    "stations.description IS NOT excluded.description OR "
+    "stations.access_public IS NOT excluded.access_public OR "
+    "stations.restrictions IS NOT excluded.restrictions OR "
+    "stations.contact_id IS NOT excluded.contact_id OR "
+    "stations.schedule_id IS NOT excluded.schedule_id OR "
+    "stations.port_ids IS NOT excluded.port_ids OR "
+    "stations.conflicts IS NOT excluded.conflicts";
+
+// every station select returns these columns, with the contact and strings the row refers to joined in
+#define select_station_columns \
+  "SELECT " \
+    "s.meta_network_ids," \
+    "s.meta_station_ids," \
+    "s.network_id," \
+    "s.station_id," \
+    "s.latitude," \
+    "s.longitude," \
+    "s.name," \
+    "s.description," \
+    "s.access_public," \
+    "s.restrictions," \
+    "s.port_ids," \
+    "schedule.string," \
+    "c.street_number," \
+    "c.street_name," \
+    "c.city," \
+    "c.state," \
+    "c.country," \
+    "c.postal_code," \
+    "phone.string," \
+    "url.string "
+
+#define join_station_strings \
+  "LEFT JOIN unique_strings schedule ON schedule.string_id = s.schedule_id " \
+  "LEFT JOIN contact c ON c.contact_id = s.contact_id " \
+  "LEFT JOIN unique_strings phone ON phone.string_id = c.phone_id " \
+  "LEFT JOIN unique_strings url ON url.string_id = c.URL_id "
+
+constexpr std::string_view sql_select_station_by_contact =
+  select_station_columns
+  "FROM "
+    "stations s "
+  join_station_strings
+  "WHERE "
+    "s.contact_id IS ?1";
+
+constexpr std::string_view sql_select_station_by_id =
+  select_station_columns
+  "FROM "
+    "stations s "
+  join_station_strings
+  "WHERE "
+    "s.network_id IS ?1 AND "
+    "s.station_id IS ?2";
+
+constexpr std::string_view sql_select_station_by_location =
+  select_station_columns
+  "FROM "
+    "stations s "
+  join_station_strings
+  "WHERE "
+    "s.latitude IS ?1 AND "
+    "s.longitude IS ?2";
+
+// expanded to batch_rows locations by multi_row(), unbound rows are NULL and match nothing
+// joined rather than a row value IN list, which SQLite answers with a full table scan
+constexpr std::string_view sql_select_stations_by_locations =
+  select_station_columns
+  "FROM "
+    "(VALUES (?1,?2)) AS locations "
+  "JOIN "
+    "stations s ON s.latitude = locations.column1 AND s.longitude = locations.column2 "
+  join_station_strings;
+
+// R*Tree entries are 32-bit floats rounded outward, so these return a superset to be filtered exactly
+constexpr std::string_view sql_select_station_locations_in_box =
+  "SELECT "
+    "s.latitude,"
+    "s.longitude "
+  "FROM "
+    "stations_rtree r JOIN stations s ON s.rowid = r.id "
+  "WHERE "
+    "r.latitude_max >= ?1 AND "
+    "r.latitude_min <= ?2 AND "
+    "r.longitude_max >= ?3 AND "
+    "r.longitude_min <= ?4";
+
+// the exact bounds test drops the extra rows of the rounded R*Tree entries
+// unary + keeps the planner on the R*Tree rather than the primary key
+constexpr std::string_view sql_select_stations_in_box =
+  select_station_columns
+  "FROM "
+    "stations_rtree r JOIN stations s ON s.rowid = r.id "
+  join_station_strings
+  "WHERE "
+    "r.latitude_max >= ?1 AND "
+    "r.latitude_min <= ?2 AND "
+    "r.longitude_max >= ?3 AND "
+    "r.longitude_min <= ?4 AND "
+    "+s.latitude BETWEEN ?1 AND ?2 AND "
+    "+s.longitude BETWEEN ?3 AND ?4";
+
+// expanded to batch_rows ports by multi_row() like the location lookup
+constexpr std::string_view sql_select_ports_by_ids =
+  "SELECT "
+    "p.network_id,"
+    "p.port_id,"
+    "p.station_id,"
+    "p.status,"
+    "p.display_name,"
+    "w.level,"
+    "w.connector,"
+    "w.amp,"
+    "w.kW,"
+    "w.volt,"
+    "c.text,"
+    "c.payment,"
+    "c.currency,"
+    "c.minimum,"
+    "c.initial,"
+    "c.unit,"
+    "c.per_unit "
+  "FROM "
+    "(VALUES (?1,?2)) AS wanted "
+  "JOIN "
+    "ports p ON p.network_id = wanted.column1 AND p.port_id = wanted.column2 "
+  "LEFT JOIN power w ON w.power_id = p.power_id "
+  "LEFT JOIN price c ON c.price_id = p.price_id";
+
+// unary + keeps the planner on the R*Tree rather than the network_id index
+// only cells whose own response listed every station inside them qualify
+constexpr std::string_view sql_select_covering_map_location =
+  "SELECT "
+    "m.network_id,"
+    "m.latitude_max,"
+    "m.latitude_min,"
+    "m.longitude_max,"
+    "m.longitude_min,"
+    "m.node_id,"
+    "m.child_ids "
+  "FROM "
+    "map_query_cache_rtree r JOIN map_query_cache m ON m.rowid = r.id "
+  "WHERE "
+    "r.latitude_min <= ?2 AND "
+    "r.latitude_max >= ?3 AND "
+    "r.longitude_min <= ?4 AND "
+    "r.longitude_max >= ?5 AND "
+    "+m.network_id = ?1 AND "
+    "m.latitude_min <= ?2 AND "
+    "m.latitude_max >= ?3 AND "
+    "m.longitude_min <= ?4 AND "
+    "m.longitude_max >= ?5 AND "
+    "EXISTS ("
+      "SELECT 1 FROM map_coverage_rtree cr JOIN map_coverage c ON c.rowid = cr.id "
+      "WHERE "
+        "cr.latitude_min <= m.latitude_min AND "
+        "cr.latitude_max >= m.latitude_max AND "
+        "cr.longitude_min <= m.longitude_min AND "
+        "cr.longitude_max >= m.longitude_max AND "
+        "c.network_id = m.network_id AND "
+        "c.latitude_min = m.latitude_min AND "
+        "c.latitude_max = m.latitude_max AND "
+        "c.longitude_min = m.longitude_min AND "
+        "c.longitude_max = m.longitude_max"
+    ") "
+  "ORDER BY (m.latitude_max - m.latitude_min) * (m.longitude_max - m.longitude_min) "
+  "LIMIT 1";
+
+constexpr std::string_view sql_select_fresh_node =
+  "SELECT "
+    "1 "
+  "FROM "
+    "fetched_nodes "
+  "WHERE "
+    "scraper IS ?1 AND "
+    "parser IS ?2 AND "
+    "node_id IS ?3 AND "
+    "last_update > datetime('now', ?4)";
+
+constexpr std::string_view sql_insert_fetched_node =
+  "INSERT INTO fetched_nodes ("
+    "scraper,"
+    "parser,"
+    "node_id,"
+    "last_update"
+  ") VALUES (?1,?2,?3,CURRENT_TIMESTAMP) "
+  "ON CONFLICT (scraper, parser, node_id) DO UPDATE SET "
+    "last_update = CURRENT_TIMESTAMP";
+
+// areas whose every station was listed by one response
+constexpr std::string_view sql_insert_covered_area =
+  "INSERT INTO map_coverage ("
+    "network_id,"
+    "latitude_max,"
+    "latitude_min,"
+    "longitude_max,"
+    "longitude_min,"
+    "last_update"
+  ") VALUES (?1,?2,?3,?4,?5,CURRENT_TIMESTAMP)";
+
+constexpr std::string_view sql_select_covering_area =
+  "SELECT "
+    "1 "
+  "FROM "
+    "map_coverage_rtree r JOIN map_coverage c ON c.rowid = r.id "
+  "WHERE "
+    "r.latitude_min <= ?2 AND "
+    "r.latitude_max >= ?3 AND "
+    "r.longitude_min <= ?4 AND "
+    "r.longitude_max >= ?5 AND "
+    "+c.network_id = ?1 AND "
+    "c.latitude_min <= ?2 AND "
+    "c.latitude_max >= ?3 AND "
+    "c.longitude_min <= ?4 AND "
+    "c.longitude_max >= ?5 AND "
+    "c.last_update > datetime('now', ?6) "
+  "LIMIT 1";
+
+constexpr std::array<std::string_view, 30> prepared_statements =
+{
+  sql_select_map_location,
+  sql_insert_map_location,
+  sql_identify_map_location,
+  sql_insert_unique_string,
+  sql_identify_unique_string,
+  sql_select_unique_string,
+  sql_insert_contact,
+  sql_identify_contact,
+  sql_select_contact,
+  sql_insert_price,
+  sql_identify_price,
+  sql_select_price,
+  sql_insert_power,
+  sql_identify_power,
+  sql_select_power,
+  sql_insert_port,
+  sql_select_port,
+  sql_insert_station,
+  sql_select_station_by_contact,
+  sql_select_station_by_id,
+  sql_select_station_by_location,
+  sql_select_stations_by_locations,
+  sql_select_station_locations_in_box,
+  sql_select_stations_in_box,
+  sql_select_ports_by_ids,
+  sql_select_covering_map_location,
+  sql_select_fresh_node,
+  sql_insert_fetched_node,
+  sql_insert_covered_area,
+  sql_select_covering_area,
+};
+
+// rows per multi-row statement, the widest (stations) stays under SQLite's historical 999 parameter limit
+constexpr std::size_t batch_rows = 64;
+
+// repeats the single row VALUES clause of a statement rows times, numbering the parameters on
+static std::string multi_row(std::string_view sql, std::size_t rows)
+{
+  std::size_t open = sql.find("VALUES (") + std::strlen("VALUES ");
+  std::size_t close = sql.find(')', open);
+  std::size_t columns = std::count(std::begin(sql) + open, std::begin(sql) + close, '?');
+
+  std::string expanded(sql.substr(0, open));
+  for(std::size_t row = 0; row < rows; ++row)
+  {
+    expanded.append(row ? ",(" : "(");
+    for(std::size_t column = 0; column < columns; ++column)
+      expanded.append(column ? ",?" : "?").append(std::to_string(row * columns + column + 1));
+    expanded.push_back(')');
+  }
+  return expanded.append(sql.substr(close + 1));
+}
+
+// prepared next to the constants
+static const std::string sql_select_stations_by_locations_batch = multi_row(sql_select_stations_by_locations, batch_rows);
+static const std::string sql_select_ports_by_ids_batch = multi_row(sql_select_ports_by_ids, batch_rows);
+static const std::string sql_insert_port_batch = multi_row(sql_insert_port, batch_rows);
+static const std::string sql_insert_station_batch = multi_row(sql_insert_station, batch_rows);
+
+DBInterface::DBInterface(std::string_view filename, bool incremental)
 {
   assert(m_db.open(filename));
 
-  const std::list<std::string_view> init_commands =
+  const std::list<std::string_view> reset_commands =
   {
-#if 1
     "DROP TABLE IF EXISTS stations",
+    "DROP TABLE IF EXISTS stations_rtree",
     "DROP TABLE IF EXISTS ports",
     "DROP TABLE IF EXISTS contacts",
     "DROP TABLE IF EXISTS price",
     "DROP TABLE IF EXISTS power",
     "DROP TABLE IF EXISTS unique_strings",
-#endif
+    "DROP TABLE IF EXISTS fetched_nodes",
+    "DROP TABLE IF EXISTS map_coverage",
+    "DROP TABLE IF EXISTS map_coverage_rtree",
+  };
+
+  const std::list<std::string_view> init_commands =
+  {
     "PRAGMA synchronous = OFF",
     "PRAGMA journal_mode = MEMORY",
 
@@ -58,22 +588,59 @@ DBInterface::DBInterface(std::string_view filename)
       "last_update" TIMESTAMP DEFAULT CURRENT_TIMESTAMP NOT NULL
     ) )",
 
+    // X'' is a BLOB and never equal to a stored value, so it stands in for NULL in unique indexes
+    "DROP TRIGGER IF EXISTS before_insert_map_query_cache_no_duplicates",
     R"(
-      CREATE TRIGGER IF NOT EXISTS before_insert_map_query_cache_no_duplicates
-      BEFORE INSERT ON map_query_cache
-      WHEN EXISTS (SELECT 1 FROM map_query_cache WHERE
-        NEW.network_id IS network_id AND
-        NEW.latitude_max IS latitude_max AND
-        NEW.latitude_min IS latitude_min AND
-        NEW.longitude_max IS longitude_max AND
-        NEW.longitude_min IS longitude_min AND
-        NEW.node_id IS node_id AND
-        NEW.child_ids IS child_ids)
+      CREATE UNIQUE INDEX IF NOT EXISTS map_query_cache_no_duplicates ON map_query_cache (
+        network_id,
+        IFNULL(node_id, X''),
+        latitude_max,
+        latitude_min,
+        longitude_max,
+        longitude_min,
+        IFNULL(child_ids, X'')
+      ) )",
+
+    "CREATE INDEX IF NOT EXISTS map_query_cache_node ON map_query_cache (network_id, node_id)",
+
+    // spatial index keyed by rowid, kept in sync by triggers (the table must never be VACUUMed)
+    "CREATE VIRTUAL TABLE IF NOT EXISTS map_query_cache_rtree USING rtree(id, latitude_min, latitude_max, longitude_min, longitude_max)",
+
+    R"(
+      CREATE TRIGGER IF NOT EXISTS map_query_cache_rtree_insert
+      AFTER INSERT ON map_query_cache
       BEGIN
-        SELECT RAISE(ABORT,SQLITE_CONSTRAINT_TRIGGER);
+        INSERT INTO map_query_cache_rtree VALUES (NEW.rowid, NEW.latitude_min, NEW.latitude_max, NEW.longitude_min, NEW.longitude_max);
       END
       )",
 
+    R"(
+      CREATE TRIGGER IF NOT EXISTS map_query_cache_rtree_update
+      AFTER UPDATE OF latitude_min, latitude_max, longitude_min, longitude_max ON map_query_cache
+      BEGIN
+        UPDATE map_query_cache_rtree SET
+          latitude_min = NEW.latitude_min,
+          latitude_max = NEW.latitude_max,
+          longitude_min = NEW.longitude_min,
+          longitude_max = NEW.longitude_max
+        WHERE id = OLD.rowid;
+      END
+      )",
+
+    R"(
+      CREATE TRIGGER IF NOT EXISTS map_query_cache_rtree_delete
+      AFTER DELETE ON map_query_cache
+      BEGIN
+        DELETE FROM map_query_cache_rtree WHERE id = OLD.rowid;
+      END
+      )",
+
+    R"(
+      INSERT INTO map_query_cache_rtree
+        SELECT rowid, latitude_min, latitude_max, longitude_min, longitude_max FROM map_query_cache
+        WHERE NOT EXISTS (SELECT 1 FROM map_query_cache_rtree WHERE id = map_query_cache.rowid)
+      )",
+
     R"(
       CREATE TRIGGER IF NOT EXISTS before_insert_map_query_cache_replace
       BEFORE INSERT ON map_query_cache
@@ -117,6 +684,39 @@ DBInterface::DBInterface(std::string_view filename)
       PRIMARY KEY (latitude, longitude)
     ) )",
 
+    "CREATE VIRTUAL TABLE IF NOT EXISTS stations_rtree USING rtree(id, latitude_min, latitude_max, longitude_min, longitude_max)",
+
+    "DROP TRIGGER IF EXISTS stations_rtree_replace",
+
+    R"(
+      CREATE TRIGGER IF NOT EXISTS stations_rtree_insert
+      AFTER INSERT ON stations
+      BEGIN
+        INSERT INTO stations_rtree VALUES (NEW.rowid, NEW.latitude, NEW.latitude, NEW.longitude, NEW.longitude);
+      END
+      )",
+
+    R"(
+      CREATE TRIGGER IF NOT EXISTS stations_rtree_update
+      AFTER UPDATE OF latitude, longitude ON stations
+      BEGIN
+        UPDATE stations_rtree SET
+          latitude_min = NEW.latitude,
+          latitude_max = NEW.latitude,
+          longitude_min = NEW.longitude,
+          longitude_max = NEW.longitude
+        WHERE id = OLD.rowid;
+      END
+      )",
+
+    R"(
+      CREATE TRIGGER IF NOT EXISTS stations_rtree_delete
+      AFTER DELETE ON stations
+      BEGIN
+        DELETE FROM stations_rtree WHERE id = OLD.rowid;
+      END
+      )",
+
     R"(
     CREATE TABLE IF NOT EXISTS ports (
       "network_id"    INTEGER   NOT NULL,
@@ -143,22 +743,18 @@ DBInterface::DBInterface(std::string_view filename)
       "URL_id"        INTEGER DEFAULT NULL
     ) )",
 
+    "DROP TRIGGER IF EXISTS before_insert_contact",
     R"(
-      CREATE TRIGGER IF NOT EXISTS before_insert_contact
-      BEFORE INSERT ON contact
-      WHEN EXISTS (SELECT 1 FROM contact WHERE
-        NEW.street_number IS street_number AND
-        NEW.street_name IS street_name AND
-        NEW.city IS city AND
-        NEW.state IS state AND
-        NEW.country IS country AND
-        NEW.postal_code IS postal_code AND
-        NEW.phone_id IS phone_id AND
-        NEW.URL_id IS URL_id)
-      BEGIN
-        SELECT RAISE(ABORT,SQLITE_CONSTRAINT_TRIGGER);
-      END
-      )",
+      CREATE UNIQUE INDEX IF NOT EXISTS contact_no_duplicates ON contact (
+        IFNULL(street_number, X''),
+        IFNULL(street_name, X''),
+        IFNULL(city, X''),
+        IFNULL(state, X''),
+        IFNULL(country, X''),
+        IFNULL(postal_code, X''),
+        IFNULL(phone_id, X''),
+        IFNULL(URL_id, X'')
+      ) )",
 
     R"(
       CREATE TABLE IF NOT EXISTS price (
@@ -172,21 +768,17 @@ DBInterface::DBInterface(std::string_view filename)
         "per_unit"  REAL    DEFAULT NULL
       ) )",
 
+    "DROP TRIGGER IF EXISTS before_insert_price",
     R"(
-      CREATE TRIGGER IF NOT EXISTS before_insert_price
-      BEFORE INSERT ON price
-      WHEN EXISTS (SELECT 1 FROM price WHERE
-        NEW.text IS text AND
-        NEW.payment IS payment AND
-        NEW.currency IS currency AND
-        NEW.minimum IS minimum AND
-        NEW.initial IS initial AND
-        NEW.unit IS unit AND
-        NEW.per_unit IS per_unit)
-      BEGIN
-        SELECT RAISE(ABORT,SQLITE_CONSTRAINT_TRIGGER);
-      END
-      )",
+      CREATE UNIQUE INDEX IF NOT EXISTS price_no_duplicates ON price (
+        IFNULL(text, X''),
+        IFNULL(payment, X''),
+        IFNULL(currency, X''),
+        IFNULL(minimum, X''),
+        IFNULL(initial, X''),
+        IFNULL(unit, X''),
+        IFNULL(per_unit, X'')
+      ) )",
 
 
     R"(
@@ -199,20 +791,53 @@ DBInterface::DBInterface(std::string_view filename)
         "volt"      REAL    DEFAULT NULL
       ) )",
 
+    "DROP TRIGGER IF EXISTS before_insert_power",
     R"(
-      CREATE TRIGGER IF NOT EXISTS before_insert_power
-      BEFORE INSERT ON power
-      WHEN EXISTS (SELECT 1 FROM power WHERE
-        NEW.level IS level AND
-        NEW.connector IS connector AND
-        NEW.amp IS amp AND
-        NEW.kW IS kW AND
-        NEW.volt IS volt)
+      CREATE UNIQUE INDEX IF NOT EXISTS power_no_duplicates ON power (
+        level,
+        IFNULL(connector, X''),
+        IFNULL(amp, X''),
+        IFNULL(kW, X''),
+        IFNULL(volt, X'')
+      ) )",
+
+
+    R"(
+      CREATE TABLE IF NOT EXISTS fetched_nodes (
+        "scraper"     TEXT      NOT NULL,
+        "parser"      INTEGER   NOT NULL,
+        "node_id"     TEXT      NOT NULL,
+        "last_update" TIMESTAMP DEFAULT CURRENT_TIMESTAMP NOT NULL,
+        PRIMARY KEY (scraper, parser, node_id)
+      ) )",
+
+    R"(
+      CREATE TABLE IF NOT EXISTS map_coverage (
+        "network_id"    INTEGER   NOT NULL,
+        "latitude_max"  REAL      NOT NULL,
+        "latitude_min"  REAL      NOT NULL,
+        "longitude_max" REAL      NOT NULL,
+        "longitude_min" REAL      NOT NULL,
+        "last_update"   TIMESTAMP DEFAULT CURRENT_TIMESTAMP NOT NULL
+      ) )",
+
+    "CREATE VIRTUAL TABLE IF NOT EXISTS map_coverage_rtree USING rtree(id, latitude_min, latitude_max, longitude_min, longitude_max)",
+
+    R"(
+      CREATE TRIGGER IF NOT EXISTS map_coverage_rtree_insert
+      AFTER INSERT ON map_coverage
       BEGIN
-        SELECT RAISE(ABORT,SQLITE_CONSTRAINT_TRIGGER);
+        INSERT INTO map_coverage_rtree VALUES (NEW.rowid, NEW.latitude_min, NEW.latitude_max, NEW.longitude_min, NEW.longitude_max);
       END
       )",
 
+    R"(
+      CREATE TRIGGER IF NOT EXISTS map_coverage_rtree_delete
+      AFTER DELETE ON map_coverage
+      BEGIN
+        DELETE FROM map_coverage_rtree WHERE id = OLD.rowid;
+      END
+      )",
 
     R"(
       CREATE TABLE IF NOT EXISTS unique_strings (
@@ -281,42 +906,344 @@ DBInterface::DBInterface(std::string_view filename)
     insert_unique_string("0,1440;0,1440;0,1440;0,1440;0,1440;0,1440;0,1440", 110),
   };
 
+  if(!incremental) // start from scratch
+    for(const auto& command : reset_commands)
+      execute(command);
+
   for(const auto& command : init_commands)
+    execute(command);
+
+  for(std::string_view sql : prepared_statements)
+    m_statements.emplace(sql, m_db.build_query(sql));
+  for(const std::string& sql : { std::cref(sql_select_stations_by_locations_batch), std::cref(sql_select_ports_by_ids_batch),
+                                     std::cref(sql_insert_port_batch), std::cref(sql_insert_station_batch) })
+    m_statements.emplace(sql, m_db.build_query(sql));
+
+  warmCaches();
+  std::cout << "database initialized" << std::endl;
+}
+
+DBInterface::~DBInterface(void)
+{
+  commitBatch();
+  if(m_add_station_count)
+    std::cout << "addStations: " << m_add_station_count << " stations, "
+              << m_add_station_us / m_add_station_count << "us average" << std::endl;
+  for(const auto& stats : cacheStats())
+    std::cout << stats.table << " cache: " << stats.entries << " entries, "
+              << stats.hits << " hits, " << stats.misses << " misses" << std::endl;
+  m_statements.clear(); // finalize before closing
+  assert(m_db.close());
+}
+
+template<typename T>
+static void hash_combine(std::size_t& seed, const T& value) noexcept
+{
+  seed ^= std::hash<T>{}(value) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+}
+
+std::size_t DBInterface::dimension_hash_t::operator()(const power_t& power) const noexcept
+{
+  std::size_t seed = 0;
+  hash_combine(seed, power.level);
+  hash_combine(seed, power.connector);
+  hash_combine(seed, power.amp);
+  hash_combine(seed, power.kw);
+  hash_combine(seed, power.volt);
+  return seed;
+}
+
+std::size_t DBInterface::dimension_hash_t::operator()(const price_t& price) const noexcept
+{
+  std::size_t seed = 0;
+  hash_combine(seed, price.text);
+  hash_combine(seed, price.payment);
+  hash_combine(seed, price.currency);
+  hash_combine(seed, price.minimum);
+  hash_combine(seed, price.initial);
+  hash_combine(seed, price.unit);
+  hash_combine(seed, price.per_unit);
+  return seed;
+}
+
+std::size_t DBInterface::dimension_hash_t::operator()(const contact_t& contact) const noexcept
+{
+  std::size_t seed = 0;
+  hash_combine(seed, contact.street_number);
+  hash_combine(seed, contact.street_name);
+  hash_combine(seed, contact.city);
+  hash_combine(seed, contact.state);
+  hash_combine(seed, contact.country);
+  hash_combine(seed, contact.postal_code);
+  return seed;
+}
+
+bool DBInterface::address_equal_t::operator()(const contact_t& a, const contact_t& b) const noexcept
+{
+  return
+      a.street_number == b.street_number &&
+      a.street_name == b.street_name &&
+      a.city == b.city &&
+      a.state == b.state &&
+      a.country == b.country &&
+      a.postal_code == b.postal_code;
+}
+
+// loads every existing dimension row, keeping the lowest id like the identify queries do
+void DBInterface::warmCaches(void)
+{
   {
-    if(!m_db.execute(command))
+    sql::query q = m_db.build_query("SELECT string_id, string FROM unique_strings ORDER BY string_id");
+    while(!q.execute() && q.lastError() == SQLITE_BUSY);
+    while(q.fetchRow())
     {
-      std::cerr << "SQL command failed:" << std::endl
-                << command << std::endl;
-      //m_db.clearError();
-      assert(false);
+      std::optional<uint64_t> string_id;
+      std::optional<std::string> ustring;
+      q.getField(string_id)
+       .getField(ustring);
+      if(string_id && ustring)
+        m_string_cache.ids.emplace(*ustring, *string_id);
+    }
+  }
+
+  {
+    sql::query q = m_db.build_query("SELECT "
+                                      "contact_id,"
+                                      "street_number,"
+                                      "street_name,"
+                                      "city,"
+                                      "state,"
+                                      "country,"
+                                      "postal_code "
+                                    "FROM contact ORDER BY contact_id");
+    while(!q.execute() && q.lastError() == SQLITE_BUSY);
+    while(q.fetchRow())
+    {
+      std::optional<uint64_t> contact_id;
+      contact_t contact;
+      q.getField(contact_id)
+       .getField(contact.street_number)
+       .getField(contact.street_name)
+       .getField(contact.city)
+       .getField(contact.state)
+       .getField(contact.country)
+       .getField(contact.postal_code);
+      if(contact_id && contact)
+        m_contact_cache.ids.emplace(contact, *contact_id);
+    }
+  }
+
+  {
+    sql::query q = m_db.build_query("SELECT "
+                                      "price_id,"
+                                      "text,"
+                                      "payment,"
+                                      "currency,"
+                                      "minimum,"
+                                      "initial,"
+                                      "unit,"
+                                      "per_unit "
+                                    "FROM price ORDER BY price_id");
+    while(!q.execute() && q.lastError() == SQLITE_BUSY);
+    while(q.fetchRow())
+    {
+      std::optional<uint64_t> price_id;
+      price_t price;
+      q.getField(price_id)
+       .getField(price.text)
+       .getField(price.payment)
+       .getField(price.currency)
+       .getField(price.minimum)
+       .getField(price.initial)
+       .getField(price.unit)
+       .getField(price.per_unit);
+      if(price_id && price)
+        m_price_cache.ids.emplace(price, *price_id);
+    }
+  }
+
+  {
+    sql::query q = m_db.build_query("SELECT "
+                                      "power_id,"
+                                      "level,"
+                                      "connector,"
+                                      "amp,"
+                                      "kW,"
+                                      "volt "
+                                    "FROM power ORDER BY power_id");
+    while(!q.execute() && q.lastError() == SQLITE_BUSY);
+    while(q.fetchRow())
+    {
+      std::optional<uint64_t> power_id;
+      power_t power;
+      q.getField(power_id)
+       .getField(power.level)
+       .getField(power.connector)
+       .getField(power.amp)
+       .getField(power.kw)
+       .getField(power.volt);
+      if(power_id && power)
+        m_power_cache.ids.emplace(power, *power_id);
     }
   }
-  std::cout << "database initialized" << std::endl;
 }
 
-DBInterface::~DBInterface(void)
+std::vector<DBInterface::cache_stats_t> DBInterface::cacheStats(void) const
 {
-  assert(m_db.close());
+  return
+  {
+    { "unique_strings", m_string_cache.ids.size(), m_string_cache.hits, m_string_cache.misses },
+    { "contact", m_contact_cache.ids.size(), m_contact_cache.hits, m_contact_cache.misses },
+    { "price", m_price_cache.ids.size(), m_price_cache.hits, m_price_cache.misses },
+    { "power", m_power_cache.ids.size(), m_power_cache.hits, m_power_cache.misses },
+  };
+}
+
+// clears the previous step and bindings of a cached statement
+// simplified revisions without query::reset() get a freshly prepared statement instead
+template<typename query_t>
+static void rewind(std::optional<query_t>& q, sql::db& db, std::string_view sql)
+{
+  if constexpr(requires(query_t& query) { query.reset(); })
+  {
+    if(q)
+    {
+      q->reset();
+      return;
+    }
+  }
+  q.emplace(db.build_query(sql));
+}
+
+sql::query& DBInterface::statement(std::string_view sql)
+{
+  auto pos = m_statements.find(sql);
+  if(pos == std::end(m_statements)) // not one of the constants, prepared on first use
+    pos = m_statements.emplace(std::string(sql), std::nullopt).first;
+  rewind(pos->second, m_db, sql);
+  return *pos->second;
+}
+
+void DBInterface::execute(std::string_view command)
+{
+  if(!m_db.execute(command))
+  {
+    std::cerr << "SQL command failed:" << std::endl
+              << command << std::endl;
+    //m_db.clearError();
+    assert(false);
+  }
+}
+
+void DBInterface::setBatchLimits(std::size_t max_stations, std::chrono::milliseconds max_age)
+{
+  m_batch_max_stations = max_stations;
+  m_batch_max_age = max_age;
+}
+
+void DBInterface::beginBatch(void)
+{
+  if(!m_batch_open)
+  {
+    execute("BEGIN TRANSACTION");
+    m_batch_open = true;
+    m_batch_stations = 0;
+    m_batch_start = std::chrono::steady_clock::now();
+  }
+}
+
+void DBInterface::commitBatch(void)
+{
+  if(m_batch_open)
+  {
+    execute("COMMIT TRANSACTION");
+    m_batch_open = false;
+  }
+}
+
+// every write joins the open batch so a crash only loses the uncommitted one
+void DBInterface::batchWritten(std::size_t count)
+{
+  if((m_batch_stations += count) >= m_batch_max_stations ||
+     std::chrono::steady_clock::now() - m_batch_start >= m_batch_max_age)
+    commitBatch();
+}
+
+void DBInterface::addCoveredArea(Network network_id, const map_bounds_t& bounds)
+{
+  beginBatch();
+  sql::query& q = statement(sql_insert_covered_area)
+                  .arg(network_id)
+                  .arg(bounds.latitude.max)
+                  .arg(bounds.latitude.min)
+                  .arg(bounds.longitude.max)
+                  .arg(bounds.longitude.min);
+
+  while(!q.execute() && q.lastError() == SQLITE_BUSY);
+  assert(q.lastError() == SQLITE_DONE);
+}
+
+// fresh means within the refresh age, or written by this run when there is none
+bool DBInterface::isCoveredArea(Network network_id, const map_bounds_t& bounds)
+{
+  std::chrono::seconds age = m_refresh_age;
+  if(age.count() <= 0)
+    age = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::steady_clock::now() - m_opened) + std::chrono::seconds(1);
+
+  sql::query& q = statement(sql_select_covering_area)
+                  .arg(network_id)
+                  .arg(bounds.latitude.min)
+                  .arg(bounds.latitude.max)
+                  .arg(bounds.longitude.min)
+                  .arg(bounds.longitude.max)
+                  .arg("-" + std::to_string(age.count()) + " seconds");
+
+  while(!q.execute() && q.lastError() == SQLITE_BUSY);
+  assert(q.lastError() == SQLITE_DONE || q.lastError() == SQLITE_ROW);
+  return q.fetchRow();
+}
+
+void DBInterface::setRefreshAge(std::chrono::seconds age)
+{
+  m_refresh_age = age;
+}
+
+// records the fetch so the next incremental run can skip it
+bool DBInterface::isFreshNode(std::string_view scraper, Parser parser, const std::string& node_id)
+{
+  if(m_refresh_age.count() <= 0)
+    return false;
+
+  sql::query& q = statement(sql_select_fresh_node)
+                  .arg(std::string(scraper))
+                  .arg(parser)
+                  .arg(node_id)
+                  .arg("-" + std::to_string(m_refresh_age.count()) + " seconds");
+
+  while(!q.execute() && q.lastError() == SQLITE_BUSY);
+  assert(q.lastError() == SQLITE_DONE || q.lastError() == SQLITE_ROW);
+  return q.fetchRow();
+}
+
+// written after the results of the node, so a failed or interrupted fetch is retried by the next run
+void DBInterface::addFetchedNode(std::string_view scraper, Parser parser, const std::string& node_id)
+{
+  beginBatch();
+  sql::query& q = statement(sql_insert_fetched_node)
+                  .arg(std::string(scraper))
+                  .arg(parser)
+                  .arg(node_id);
+
+  while(!q.execute() && q.lastError() == SQLITE_BUSY);
+  assert(q.lastError() == SQLITE_DONE);
 }
 
 std::optional<pair_data_t> DBInterface::getMapLocation(Network network_id, const std::string& node_id)
 {
   std::optional<pair_data_t> return_data;
-  sql::query q = std::move(m_db.build_query("SELECT "
-                                              "network_id,"
-                                              "latitude_max,"
-                                              "latitude_min,"
-                                              "longitude_max,"
-                                              "longitude_min,"
-                                              "node_id,"
-                                              "child_ids "
-                                            "FROM "
-                                              "map_query_cache "
-                                            "WHERE "
-                                              "network_id IS ?1 AND "
-                                              "node_id IS ?2")
-                           .arg(network_id)
-                           .arg(node_id));
+  sql::query& q = statement(sql_select_map_location)
+                  .arg(network_id)
+                  .arg(node_id);
   while(!q.execute() && q.lastError() == SQLITE_BUSY);
   while(q.fetchRow())
   {
@@ -345,52 +1272,32 @@ void DBInterface::addMapLocation(const pair_data_t& data)
 {
   MUST(data.station.network_id && data.query.node_id)
   {
-    sql::query q = std::move(m_db.build_query("INSERT INTO map_query_cache ("
-                                                "network_id,"
-                                                "latitude_max,"
-                                                "latitude_min,"
-                                                "longitude_max,"
-                                                "longitude_min,"
-                                                "node_id,"
-                                                "child_ids,"
-                                                "last_update"
-                                              ") VALUES (?1,?2,?3,?4,?5,?6,?7,CURRENT_TIMESTAMP)")
-                             .arg(data.station.network_id)
-                             .arg(data.query.bounds.latitude.max)
-                             .arg(data.query.bounds.latitude.min)
-                             .arg(data.query.bounds.longitude.max)
-                             .arg(data.query.bounds.longitude.min)
-                             .arg(data.query.node_id)
-                             .arg(data.query.child_ids));
+    beginBatch();
+    sql::query& q = statement(sql_insert_map_location)
+                    .arg(data.station.network_id)
+                    .arg(data.query.bounds.latitude.max)
+                    .arg(data.query.bounds.latitude.min)
+                    .arg(data.query.bounds.longitude.max)
+                    .arg(data.query.bounds.longitude.min)
+                    .arg(data.query.node_id)
+                    .arg(data.query.child_ids);
 
     while(!q.execute() && q.lastError() == SQLITE_BUSY);
-    assert(q.lastError() == SQLITE_DONE || q.lastError() == SQLITE_CONSTRAINT_TRIGGER);
+    assert(q.lastError() == SQLITE_DONE);
+    batchWritten();
   }
 }
 
 std::optional<std::string> DBInterface::identifyMapLocation(const pair_data_t& data)
 {
   std::optional<std::string> node_id;
-  sql::query q = std::move(m_db.build_query("SELECT "
-                                              "node_id "
-                                            "FROM "
-                                              "map_query_cache "
-                                            "WHERE "
-                                              "network_id IS ?1 AND "
-                                              "node_id IS ?2 AND "
-                                              "latitude_max IS ?3 AND "
-                                              "latitude_min IS ?4 AND "
-                                              "longitude_max IS ?5 AND "
-                                              "longitude_min IS ?6"
-//                                              "ABS(latitude_max  - latitude_min ) <= ABS(?3 - ?4) AND "
-//                                              "ABS(longitude_max - longitude_min) <= ABS(?5 - ?6)"
-                                            )
-                           .arg(data.station.network_id)
-                           .arg(data.query.node_id)
-                           .arg(data.query.bounds.latitude.max)
-                           .arg(data.query.bounds.latitude.min)
-                           .arg(data.query.bounds.longitude.max)
-                           .arg(data.query.bounds.longitude.min));
+  sql::query& q = statement(sql_identify_map_location)
+                  .arg(data.station.network_id)
+                  .arg(data.query.node_id)
+                  .arg(data.query.bounds.latitude.max)
+                  .arg(data.query.bounds.latitude.min)
+                  .arg(data.query.bounds.longitude.max)
+                  .arg(data.query.bounds.longitude.min);
   while(!q.execute() && q.lastError() == SQLITE_BUSY);
   if(q.fetchRow())
     q.getField(node_id);
@@ -399,9 +1306,10 @@ std::optional<std::string> DBInterface::identifyMapLocation(const pair_data_t& d
 
 void DBInterface::addUniqueString(const std::optional<std::string>& ustring)
 {
-  if(ustring)
+  if(ustring && !m_string_cache.ids.contains(*ustring))
   {
-    sql::query q = std::move(m_db.build_query("INSERT INTO unique_strings (string) VALUES (?1)").arg(ustring));
+    beginBatch();
+    sql::query& q = statement(sql_insert_unique_string).arg(ustring);
 
     while(!q.execute() && q.lastError() == SQLITE_BUSY);
     assert(q.lastError() == SQLITE_DONE || q.lastError() == SQLITE_CONSTRAINT_UNIQUE);
@@ -413,13 +1321,18 @@ std::optional<uint64_t> DBInterface::identifyUniqueString(const std::optional<st
   std::optional<uint64_t> string_id;
   if(ustring)
   {
-    sql::query q = std::move(m_db.build_query("SELECT string_id FROM unique_strings WHERE string IS ?1").arg(ustring));
+    if((string_id = m_string_cache.find(*ustring)))
+      return string_id;
+
+    sql::query& q = statement(sql_identify_unique_string).arg(ustring);
 
     while(!q.execute() && q.lastError() == SQLITE_BUSY);
     assert(q.lastError() == SQLITE_DONE || q.lastError() == SQLITE_ROW);
 
     MUST(q.fetchRow())
       q.getField(string_id);
+    if(string_id)
+      m_string_cache.ids.emplace(*ustring, *string_id);
   }
   return string_id;
 }
@@ -429,7 +1342,7 @@ std::optional<std::string> DBInterface::getUniqueString(const std::optional<uint
   std::optional<std::string> ustring;
   if(string_id)
   {
-    sql::query q = std::move(m_db.build_query("SELECT string FROM unique_strings WHERE string_id IS ?1").arg(string_id));
+    sql::query& q = statement(sql_select_unique_string).arg(string_id);
 
     while(!q.execute() && q.lastError() == SQLITE_BUSY);
     assert(q.lastError() == SQLITE_DONE || q.lastError() == SQLITE_ROW);
@@ -442,6 +1355,10 @@ std::optional<std::string> DBInterface::getUniqueString(const std::optional<uint
 
 void DBInterface::addContact(const contact_t& contact)
 {
+  if(contact && m_contact_cache.ids.contains(contact))
+    return;
+
+  beginBatch();
   addUniqueString(contact.phone_number);
   addUniqueString(contact.URL);
 
@@ -450,27 +1367,18 @@ void DBInterface::addContact(const contact_t& contact)
 
   if(contact)
   {
-    sql::query q = std::move(m_db.build_query("INSERT INTO contact ("
-                                                "street_number,"
-                                                "street_name,"
-                                                "city,"
-                                                "state,"
-                                                "country,"
-                                                "postal_code,"
-                                                "phone_id,"
-                                                "URL_id"
-                                              ") VALUES (?1,?2,?3,?4,?5,?6,?7,?8)")
-                             .arg(contact.street_number)
-                             .arg(contact.street_name)
-                             .arg(contact.city)
-                             .arg(contact.state)
-                             .arg(contact.country)
-                             .arg(contact.postal_code)
-                             .arg(phone_id)
-                             .arg(URL_id));
+    sql::query& q = statement(sql_insert_contact)
+                    .arg(contact.street_number)
+                    .arg(contact.street_name)
+                    .arg(contact.city)
+                    .arg(contact.state)
+                    .arg(contact.country)
+                    .arg(contact.postal_code)
+                    .arg(phone_id)
+                    .arg(URL_id);
 
     while(!q.execute() && q.lastError() == SQLITE_BUSY);
-    assert(q.lastError() == SQLITE_DONE || q.lastError() == SQLITE_CONSTRAINT_TRIGGER);
+    assert(q.lastError() == SQLITE_DONE);
   }
 }
 
@@ -479,29 +1387,24 @@ std::optional<uint64_t> DBInterface::identifyContact(const contact_t& contact)
   std::optional<uint64_t> contact_id;
   if(contact)
   {
-    sql::query q = std::move(m_db.build_query("SELECT "
-                                                "contact_id "
-                                              "FROM "
-                                                "contact "
-                                              "WHERE "
-                                                "street_number IS ?1 AND "
-                                                "street_name IS ?2 AND "
-                                                "city IS ?3 AND "
-                                                "state IS ?4 AND "
-                                                "country IS ?5 AND "
-                                                "postal_code IS ?6")
-                             .arg(contact.street_number)
-                             .arg(contact.street_name)
-                             .arg(contact.city)
-                             .arg(contact.state)
-                             .arg(contact.country)
-                             .arg(contact.postal_code));
+    if((contact_id = m_contact_cache.find(contact)))
+      return contact_id;
+
+    sql::query& q = statement(sql_identify_contact)
+                    .arg(contact.street_number)
+                    .arg(contact.street_name)
+                    .arg(contact.city)
+                    .arg(contact.state)
+                    .arg(contact.country)
+                    .arg(contact.postal_code);
 
     while(!q.execute() && q.lastError() == SQLITE_BUSY);
     assert(q.lastError() == SQLITE_DONE || q.lastError() == SQLITE_ROW);
 
     MUST(q.fetchRow())
       q.getField(contact_id);
+    if(contact_id)
+      m_contact_cache.ids.emplace(contact, *contact_id);
   }
   return contact_id;
 }
@@ -513,20 +1416,8 @@ contact_t DBInterface::getContact(const std::optional<uint64_t> contact_id)
   {
     std::optional<uint64_t> URL_id, phone_id;
     { // scope for sql::query type
-      sql::query q = std::move(m_db.build_query("SELECT "
-                                                  "street_number,"
-                                                  "street_name,"
-                                                  "city,"
-                                                  "state,"
-                                                  "country,"
-                                                  "postal_code,"
-                                                  "phone_id,"
-                                                  "URL_id "
-                                                "FROM "
-                                                  "contact "
-                                                "WHERE "
-                                                  "contact_id IS ?1")
-                               .arg(contact_id));
+      sql::query& q = statement(sql_select_contact)
+                      .arg(contact_id);
 
       while(!q.execute() && q.lastError() == SQLITE_BUSY);
       assert(q.lastError() == SQLITE_DONE || q.lastError() == SQLITE_ROW);
@@ -553,27 +1444,20 @@ contact_t DBInterface::getContact(const std::optional<uint64_t> contact_id)
 
 void DBInterface::addPrice(const price_t& price)
 {
-  if(price)
+  if(price && !m_price_cache.ids.contains(price))
   {
-    sql::query q = std::move(m_db.build_query("INSERT INTO price ("
-                                                "text,"
-                                                "payment,"
-                                                "currency,"
-                                                "minimum,"
-                                                "initial,"
-                                                "unit,"
-                                                "per_unit"
-                                              ") VALUES (?1,?2,?3,?4,?5,?6,?7)")
-                             .arg(price.text)
-                             .arg(price.payment)
-                             .arg(price.currency)
-                             .arg(price.minimum)
-                             .arg(price.initial)
-                             .arg(price.unit)
-                             .arg(price.per_unit));
+    beginBatch();
+    sql::query& q = statement(sql_insert_price)
+                    .arg(price.text)
+                    .arg(price.payment)
+                    .arg(price.currency)
+                    .arg(price.minimum)
+                    .arg(price.initial)
+                    .arg(price.unit)
+                    .arg(price.per_unit);
 
     while(!q.execute() && q.lastError() == SQLITE_BUSY);
-    assert(q.lastError() == SQLITE_DONE || q.lastError() == SQLITE_CONSTRAINT_TRIGGER);
+    assert(q.lastError() == SQLITE_DONE);
   }
 }
 
@@ -582,31 +1466,25 @@ std::optional<uint64_t> DBInterface::identifyPrice(const price_t& price)
   std::optional<uint64_t> price_id;
   if(price)
   {
-    sql::query q = std::move(m_db.build_query("SELECT "
-                                                "price_id "
-                                              "FROM "
-                                                "price "
-                                              "WHERE "
-                                                "text IS ?1 AND "
-                                                "payment IS ?2 AND "
-                                                "currency IS ?3 AND "
-                                                "minimum IS ?4 AND "
-                                                "initial IS ?5 AND "
-                                                "unit IS ?6 AND "
-                                                "per_unit IS ?7")
-                             .arg(price.text)
-                             .arg(price.payment)
-                             .arg(price.currency)
-                             .arg(price.minimum)
-                             .arg(price.initial)
-                             .arg(price.unit)
-                             .arg(price.per_unit));
+    if((price_id = m_price_cache.find(price)))
+      return price_id;
+
+    sql::query& q = statement(sql_identify_price)
+                    .arg(price.text)
+                    .arg(price.payment)
+                    .arg(price.currency)
+                    .arg(price.minimum)
+                    .arg(price.initial)
+                    .arg(price.unit)
+                    .arg(price.per_unit);
 
     while(!q.execute() && q.lastError() == SQLITE_BUSY);
     assert(q.lastError() == SQLITE_DONE || q.lastError() == SQLITE_ROW);
 
     MUST(q.fetchRow())
       q.getField(price_id);
+    if(price_id)
+      m_price_cache.ids.emplace(price, *price_id);
   }
   return price_id;
 }
@@ -616,19 +1494,8 @@ price_t DBInterface::getPrice(const std::optional<uint64_t> price_id)
   price_t price;
   if(price_id)
   {
-    sql::query q = std::move(m_db.build_query("SELECT "
-                                                "text,"
-                                                "payment,"
-                                                "currency,"
-                                                "minimum,"
-                                                "initial,"
-                                                "unit,"
-                                                "per_unit "
-                                              "FROM "
-                                                "price "
-                                              "WHERE "
-                                                "price_id IS ?1")
-                             .arg(price_id));
+    sql::query& q = statement(sql_select_price)
+                    .arg(price_id);
 
     while(!q.execute() && q.lastError() == SQLITE_BUSY);
     assert(q.lastError() == SQLITE_DONE || q.lastError() == SQLITE_ROW);
@@ -648,23 +1515,18 @@ price_t DBInterface::getPrice(const std::optional<uint64_t> price_id)
 
 void DBInterface::addPower(const power_t& power)
 {
-  if(power)
+  if(power && !m_power_cache.ids.contains(power))
   {
-    sql::query q = std::move(m_db.build_query("INSERT INTO power ("
-                                                "level,"
-                                                "connector,"
-                                                "amp,"
-                                                "kW,"
-                                                "volt"
-                                              ") VALUES (?1,?2,?3,?4,?5)")
-                             .arg(power.level)
-                             .arg(power.connector)
-                             .arg(power.amp)
-                             .arg(power.kw)
-                             .arg(power.volt));
+    beginBatch();
+    sql::query& q = statement(sql_insert_power)
+                    .arg(power.level)
+                    .arg(power.connector)
+                    .arg(power.amp)
+                    .arg(power.kw)
+                    .arg(power.volt);
 
     while(!q.execute() && q.lastError() == SQLITE_BUSY);
-    assert(q.lastError() == SQLITE_DONE || q.lastError() == SQLITE_CONSTRAINT_TRIGGER);
+    assert(q.lastError() == SQLITE_DONE);
   }
 }
 
@@ -674,27 +1536,23 @@ std::optional<uint64_t> DBInterface::identifyPower(const power_t& power)
   std::optional<uint64_t> power_id;
   if(power)
   {
-    sql::query q = std::move(m_db.build_query("SELECT "
-                                                "power_id "
-                                              "FROM "
-                                                "power "
-                                              "WHERE "
-                                                "level IS ?1 AND "
-                                                "connector IS ?2 AND "
-                                                "amp IS ?3 AND "
-                                                "kW IS ?4 AND "
-                                                "volt IS ?5")
-                             .arg(power.level)
-                             .arg(power.connector)
-                             .arg(power.amp)
-                             .arg(power.kw)
-                             .arg(power.volt));
+    if((power_id = m_power_cache.find(power)))
+      return power_id;
+
+    sql::query& q = statement(sql_identify_power)
+                    .arg(power.level)
+                    .arg(power.connector)
+                    .arg(power.amp)
+                    .arg(power.kw)
+                    .arg(power.volt);
 
     while(!q.execute() && q.lastError() == SQLITE_BUSY);
     assert(q.lastError() == SQLITE_DONE || q.lastError() == SQLITE_ROW);
 
     MUST(q.fetchRow())
       q.getField(power_id);
+    if(power_id)
+      m_power_cache.ids.emplace(power, *power_id);
   }
   return power_id;
 }
@@ -704,17 +1562,8 @@ power_t DBInterface::getPower(const std::optional<uint64_t> power_id)
   power_t power;
   if(power_id)
   {
-    sql::query q = std::move(m_db.build_query("SELECT "
-                                                "level,"
-                                                "connector,"
-                                                "amp,"
-                                                "kW,"
-                                                "volt "
-                                              "FROM "
-                                                "power "
-                                              "WHERE "
-                                                "power_id IS ?1")
-                             .arg(power_id));
+    sql::query& q = statement(sql_select_power)
+                    .arg(power_id);
 
     while(!q.execute() && q.lastError() == SQLITE_BUSY);
     assert(q.lastError() == SQLITE_DONE || q.lastError() == SQLITE_ROW);
@@ -730,6 +1579,16 @@ power_t DBInterface::getPower(const std::optional<uint64_t> power_id)
 }
 
 void DBInterface::addPort(port_t& port)
+{
+  beginBatch();
+  sql::query& q = bindPort(statement(sql_insert_port), port);
+
+  while(!q.execute() && q.lastError() == SQLITE_BUSY);
+  assert(q.lastError() == SQLITE_DONE);
+}
+
+// stores the dimensions of the port and appends its row to the bindings of q
+sql::query& DBInterface::bindPort(sql::query& q, port_t& port)
 {
   addPower(port.power);
   addPrice(port.price);
@@ -737,25 +1596,13 @@ void DBInterface::addPort(port_t& port)
   std::optional<uint64_t> power_id = identifyPower(port.power);
   std::optional<uint64_t> price_id = identifyPrice(port.price);
 
-  sql::query q = std::move(m_db.build_query("INSERT INTO ports ("
-                                              "network_id,"
-                                              "port_id,"
-                                              "station_id,"
-                                              "power_id,"
-                                              "price_id,"
-                                              "status,"
-                                              "display_name"
-                                            ") VALUES (?1,?2,?3,?4,?5,?6,?7)")
-                           .arg(port.network_id)
-                           .arg(port.port_id)
-                           .arg(port.station_id)
-                           .arg(power_id)
-                           .arg(price_id)
-                           .arg(port.status)
-                           .arg(port.display_name));
-
-  while(!q.execute() && q.lastError() == SQLITE_BUSY);
-  assert(q.lastError() == SQLITE_DONE || q.lastError() == SQLITE_CONSTRAINT_PRIMARYKEY);
+  return q.arg(port.network_id)
+          .arg(port.port_id)
+          .arg(port.station_id)
+          .arg(power_id)
+          .arg(price_id)
+          .arg(port.status)
+          .arg(port.display_name);
 }
 
 port_t DBInterface::getPort(Network network_id, const std::string& port_id)
@@ -765,19 +1612,9 @@ port_t DBInterface::getPort(Network network_id, const std::string& port_id)
   port.network_id = network_id;
   port.port_id = port_id;
   {
-    sql::query q = std::move(m_db.build_query("SELECT "
-                                                "station_id,"
-                                                "power_id,"
-                                                "price_id,"
-                                                "status,"
-                                                "display_name "
-                                              "FROM "
-                                                "ports "
-                                              "WHERE "
-                                                "network_id IS ?1 AND "
-                                                "port_id IS ?2")
-                             .arg(port.network_id)
-                             .arg(port.port_id));
+    sql::query& q = statement(sql_select_port)
+                    .arg(port.network_id)
+                    .arg(port.port_id);
 
     while(!q.execute() && q.lastError() == SQLITE_BUSY);
     assert(q.lastError() == SQLITE_DONE || q.lastError() == SQLITE_ROW);
@@ -798,158 +1635,273 @@ port_t DBInterface::getPort(Network network_id, const std::string& port_id)
 
 void DBInterface::addStation(station_t& station)
 {
+  addStations(std::span<station_t>(&station, 1));
+}
+
+// one lookup and one multi-row upsert per batch_rows stations instead of a round trip per row
+void DBInterface::addStations(std::span<station_t> stations)
+{
+  if(stations.empty())
+    return;
+
+  auto start = std::chrono::steady_clock::now();
+  beginBatch();
   try
   {
-    std::optional<uint64_t> contact_id, schedule_id;
-    bool conflicts = station.incorporate(getStation(station.location));
+    std::map<std::pair<double, double>, station_t> existing; // empty for locations not stored yet
+    std::vector<coords_t> locations; // each once, the lookup returns a row per listed location
+    for(const station_t& station : stations)
+      if(existing.try_emplace({ station.location.latitude, station.location.longitude }).second)
+        locations.push_back(station.location);
+
+    for(station_t& stored : getStations(locations))
+      existing[{ stored.location.latitude, stored.location.longitude }] = std::move(stored);
+
+    // a location listed twice merges into its earlier record, as if it had been written in between
+    std::map<std::pair<double, double>, written_station_t> latest;
+    for(station_t& station : stations)
+    {
+      std::pair<double, double> location = { station.location.latitude, station.location.longitude };
+      bool conflicts;
+      if(auto prior = latest.find(location); prior != std::end(latest))
+        conflicts = station.incorporate(*prior->second.station);
+      else
+        conflicts = station.incorporate(existing[location]);
+
+      assert(!station.ports.empty());
+      written_station_t& written = latest[location];
+      written = syncStation(station);
+      written.station = &station;
+      written.conflicts = conflicts;
+    }
 
-    assert(!station.ports.empty());
+    std::vector<port_t*> ports;
+    for(auto& [location, written] : latest)
+      for(port_t& port : written.station->ports)
+        ports.push_back(&port);
 
-    { // sync contact structs
-      contact_t contact;
-      for(auto& port : station.ports)
-      {
-        if(port.contact)
-        {
-          if(!contact)
-            contact = port.contact;
-          else
-            assert(contact == port.contact);
-        }
-      }
-      if(!contact && station.contact)
-        contact = station.contact;
-      if(contact)
-        addContact(contact);
+    // full chunks go through the multi-row statements, the remainder row by row
+    for(std::size_t row = 0; row < ports.size(); )
+    {
+      std::size_t rows = ports.size() - row >= batch_rows ? batch_rows : 1;
+      sql::query& q = statement(rows == 1 ? sql_insert_port : std::string_view(sql_insert_port_batch));
+      for(std::size_t end = row + rows; row < end; ++row)
+        bindPort(q, *ports[row]);
 
-      contact_id = identifyContact(contact);
-      station.contact = contact;
+      while(!q.execute() && q.lastError() == SQLITE_BUSY);
+      assert(q.lastError() == SQLITE_DONE);
     }
 
-    if(station.price) // sync price structs
+    auto pos = std::begin(latest);
+    for(std::size_t remaining = latest.size(); remaining; )
     {
-      for(auto& port : station.ports)
-        if(!port.price)
-          port.price = station.price;
-    }
+      std::size_t rows = remaining >= batch_rows ? batch_rows : 1;
+      sql::query& q = statement(rows == 1 ? sql_insert_station : std::string_view(sql_insert_station_batch));
+      for(remaining -= rows; rows; --rows, ++pos)
+        bindStation(q, pos->second);
 
-    for(auto& port : station.ports) // add ports to database
-    {
-      port.station_id = station.station_id; // sync station and network ids
-      port.network_id = station.network_id;
-      addPort(port);
+      while(!q.execute() && q.lastError() == SQLITE_BUSY);
+      assert(q.lastError() == SQLITE_DONE);
     }
+  }
+  catch(std::string& error)
+  {
+    std::cerr << "sql error: " << error << std::endl;
+  }
+  batchWritten(stations.size());
+  m_add_station_count += stations.size();
+  m_add_station_us += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+}
 
-    if(!station.schedule.empty())
+// shares the contact and price between the station and its ports and stores the contact and schedule
+DBInterface::written_station_t DBInterface::syncStation(station_t& station)
+{
+  written_station_t written;
+
+  { // sync contact structs
+    contact_t contact;
+    for(auto& port : station.ports)
     {
-      addUniqueString(station.schedule);
-      schedule_id = identifyUniqueString(station.schedule);
+      if(port.contact)
+      {
+        if(!contact)
+          contact = port.contact;
+        else
+          assert(contact == port.contact);
+      }
     }
+    if(!contact && station.contact)
+      contact = station.contact;
+    if(contact)
+      addContact(contact);
 
-    sql::query q = std::move(m_db.build_query("INSERT OR REPLACE INTO stations ("
-                                                "meta_network_ids,"
-                                                "meta_station_ids,"
-                                                "network_id,"
-                                                "station_id,"
-                                                "latitude,"
-                                                "longitude,"
-                                                "name,"
-                                                "description,"
-                                                "access_public,"
-                                                "restrictions,"
-                                                "contact_id,"
-                                                "schedule_id,"
-                                                "port_ids,"
-                                                "conflicts"
-                                              ") VALUES (?1,?2,?3,?4,?5,?6,?7,?8,?9,?10,?11,?12,?13,?14)")
-                             .arg(to_optional(ext::to_string<Network>(station.meta_network_ids)))
-                             .arg(to_optional(ext::to_string(station.meta_station_ids)))
-                             .arg(station.network_id)
-                             .arg(station.station_id)
-                             .arg(station.location.latitude)
-                             .arg(station.location.longitude)
-                             .arg(station.name)
-                             .arg(station.description)
-                             .arg(station.access_public)
-                             .arg(station.restrictions)
-                             .arg(contact_id)
-                             .arg(schedule_id)
-                             .arg(to_optional(ext::to_string<port_t>(station.ports, [](const port_t& p) { return *p.port_id; })))
-                             .arg(conflicts));
+    written.contact_id = identifyContact(contact);
+    station.contact = contact;
+  }
 
-    while(!q.execute() && q.lastError() == SQLITE_BUSY);
-    assert(q.lastError() == SQLITE_DONE || q.lastError() == SQLITE_CONSTRAINT_PRIMARYKEY);
+  if(station.price) // sync price structs
+  {
+    for(auto& port : station.ports)
+      if(!port.price)
+        port.price = station.price;
   }
-  catch(std::string& error)
+
+  for(auto& port : station.ports) // sync station and network ids
   {
-    std::cerr << "sql error: " << error << std::endl;
+    port.station_id = station.station_id;
+    port.network_id = station.network_id;
   }
+
+  if(!station.schedule.empty())
+  {
+    addUniqueString(station.schedule);
+    written.schedule_id = identifyUniqueString(station.schedule);
+  }
+
+  return written;
 }
 
-station_t DBInterface::getStation(sql::query&& q)
+// appends the row of a synced station to the bindings of q
+sql::query& DBInterface::bindStation(sql::query& q, const written_station_t& written)
 {
-  station_t station;
+  const station_t& station = *written.station;
+  return q.arg(to_optional(ext::to_string<Network>(station.meta_network_ids)))
+          .arg(to_optional(ext::to_string(station.meta_station_ids)))
+          .arg(station.network_id)
+          .arg(station.station_id)
+          .arg(station.location.latitude)
+          .arg(station.location.longitude)
+          .arg(station.name)
+          .arg(station.description)
+          .arg(station.access_public)
+          .arg(station.restrictions)
+          .arg(written.contact_id)
+          .arg(written.schedule_id)
+          .arg(to_optional(ext::to_string<port_t>(station.ports, [](const port_t& p) { return *p.port_id; })))
+          .arg(written.conflicts);
+}
+
+station_t DBInterface::getStation(sql::query& q)
+{
+  std::vector<station_t> stations;
+  fetchStations(q, stations);
+  hydratePorts(stations);
+  if(stations.empty())
+    return {};
+  return std::move(stations.front());
+}
 
+// runs q and appends the stations it returns, their ports still to be hydrated
+void DBInterface::fetchStations(sql::query& q, std::vector<station_t>& stations)
+{
   while(!q.execute() && q.lastError() == SQLITE_BUSY);
   assert(q.lastError() == SQLITE_DONE || q.lastError() == SQLITE_ROW);
 
-  if(q.fetchRow())
+  while(q.fetchRow())
+    stations.emplace_back(readStation(q));
+}
+
+// reads the row q has just fetched, the ports only get their ids until hydratePorts()
+station_t DBInterface::readStation(sql::query& q)
+{
+  station_t station;
+  std::optional<std::string> meta_network_ids, meta_station_ids, schedule;
+  std::string port_ids;
+
+  q.getField(meta_network_ids)
+   .getField(meta_station_ids)
+   .getField(station.network_id)
+   .getField(station.station_id)
+   .getField(station.location.latitude)
+   .getField(station.location.longitude)
+   .getField(station.name)
+   .getField(station.description)
+   .getField(station.access_public)
+   .getField(station.restrictions)
+   .getField(port_ids)
+   .getField(schedule)
+   .getField(station.contact.street_number)
+   .getField(station.contact.street_name)
+   .getField(station.contact.city)
+   .getField(station.contact.state)
+   .getField(station.contact.country)
+   .getField(station.contact.postal_code)
+   .getField(station.contact.phone_number)
+   .getField(station.contact.URL);
+
+  station.meta_network_ids = ext::to_list<Network>(meta_network_ids);
+  station.meta_station_ids = ext::to_list(meta_station_ids);
+
+  station.ports = ext::to_list<port_t>(port_ids,
+                                       [&station](const std::string& port_id)
+                                       {
+                                         port_t port;
+                                         port.network_id = station.network_id;
+                                         port.port_id = port_id;
+                                         return port;
+                                       });
+
+  station.schedule = schedule;
+  return station;
+}
+
+// fills in every port of the stations with one query per batch_rows ports, power and price joined in
+void DBInterface::hydratePorts(std::span<station_t> stations)
+{
+  std::map<std::pair<Network, std::string>, port_t> ports;
+  for(const station_t& station : stations)
+    for(const port_t& port : station.ports)
+      ports.emplace(std::make_pair(*port.network_id, *port.port_id), port);
+
+  for(auto pos = std::begin(ports); pos != std::end(ports); )
   {
-    std::optional<std::string> meta_network_ids, meta_station_ids;
-    std::optional<uint64_t> contact_id, schedule_id;
-    std::string port_ids;
-
-    q.getField(meta_network_ids)
-     .getField(meta_station_ids)
-     .getField(station.network_id)
-     .getField(station.station_id)
-     .getField(station.location.latitude)
-     .getField(station.location.longitude)
-     .getField(station.name)
-     .getField(station.description)
-     .getField(station.access_public)
-     .getField(station.restrictions)
-     .getField(contact_id)
-     .getField(schedule_id)
-     .getField(port_ids);
-
-    station.meta_network_ids = ext::to_list<Network>(meta_network_ids);
-    station.meta_station_ids = ext::to_list(meta_station_ids);
-
-    station.ports = ext::to_list<port_t>(port_ids,
-                                         [&station, this](const std::string& port_id)
-                                         { return getPort(*station.network_id, port_id); });
-
-    station.contact = getContact(contact_id);
-    station.schedule = getUniqueString(schedule_id);
+    sql::query& q = statement(sql_select_ports_by_ids_batch);
+    for(std::size_t rows = 0; rows < batch_rows && pos != std::end(ports); ++rows, ++pos)
+      q.arg(pos->first.first)
+       .arg(pos->first.second);
+
+    while(!q.execute() && q.lastError() == SQLITE_BUSY);
+    assert(q.lastError() == SQLITE_DONE || q.lastError() == SQLITE_ROW);
+
+    while(q.fetchRow())
+    {
+      port_t port;
+      std::optional<Payment> payment; // NULL without a price row
+      q.getField(port.network_id)
+       .getField(port.port_id)
+       .getField(port.station_id)
+       .getField(port.status)
+       .getField(port.display_name)
+       .getField(port.power.level)
+       .getField(port.power.connector)
+       .getField(port.power.amp)
+       .getField(port.power.kw)
+       .getField(port.power.volt)
+       .getField(port.price.text)
+       .getField(payment)
+       .getField(port.price.currency)
+       .getField(port.price.minimum)
+       .getField(port.price.initial)
+       .getField(port.price.unit)
+       .getField(port.price.per_unit);
+      if(payment)
+        port.price.payment = *payment;
+
+      ports[std::make_pair(*port.network_id, *port.port_id)] = std::move(port);
+    }
   }
 
-  return station;
+  for(station_t& station : stations)
+    for(port_t& port : station.ports)
+      port = ports[std::make_pair(*port.network_id, *port.port_id)];
 }
 
 station_t DBInterface::getStation(uint64_t contact_id)
 {
   try
   {
-    return getStation(std::move(m_db.build_query( "SELECT "
-                                                    "meta_network_ids,"
-                                                    "meta_station_ids,"
-                                                    "network_id,"
-                                                    "station_id,"
-                                                    "latitude,"
-                                                    "longitude,"
-                                                    "name,"
-                                                    "description,"
-                                                    "access_public,"
-                                                    "restrictions,"
-                                                    "contact_id,"
-                                                    "schedule_id,"
-                                                    "port_ids "
-                                                  "FROM "
-                                                    "stations "
-                                                  "WHERE "
-                                                    "contact_id IS ?1")
-                                  .arg(contact_id)));
+    return getStation(statement(sql_select_station_by_contact)
+                      .arg(contact_id));
   }
   catch(std::string& error)
   {
@@ -962,27 +1914,9 @@ station_t DBInterface::getStation(Network network_id, const std::string& station
 {
   try
   {
-    return getStation(std::move(m_db.build_query( "SELECT "
-                                                    "meta_network_ids,"
-                                                    "meta_station_ids,"
-                                                    "network_id,"
-                                                    "station_id,"
-                                                    "latitude,"
-                                                    "longitude,"
-                                                    "name,"
-                                                    "description,"
-                                                    "access_public,"
-                                                    "restrictions,"
-                                                    "contact_id,"
-                                                    "schedule_id,"
-                                                    "port_ids "
-                                                  "FROM "
-                                                    "stations "
-                                                  "WHERE "
-                                                    "network_id IS ?1 AND "
-                                                    "station_id IS ?2")
-                                .arg(network_id)
-                                .arg(station_id)));
+    return getStation(statement(sql_select_station_by_id)
+                      .arg(network_id)
+                      .arg(station_id));
   }
   catch(std::string& error)
   {
@@ -995,27 +1929,9 @@ station_t DBInterface::getStation(coords_t location)
 {
   try
   {
-    return getStation(std::move(m_db.build_query( "SELECT "
-                                                    "meta_network_ids,"
-                                                    "meta_station_ids,"
-                                                    "network_id,"
-                                                    "station_id,"
-                                                    "latitude,"
-                                                    "longitude,"
-                                                    "name,"
-                                                    "description,"
-                                                    "access_public,"
-                                                    "restrictions,"
-                                                    "contact_id,"
-                                                    "schedule_id,"
-                                                    "port_ids "
-                                                  "FROM "
-                                                    "stations "
-                                                  "WHERE "
-                                                    "latitude IS ?1 AND "
-                                                    "longitude IS ?2")
-                                .arg(location.latitude)
-                                .arg(location.longitude)));
+    return getStation(statement(sql_select_station_by_location)
+                      .arg(location.latitude)
+                      .arg(location.longitude));
   }
   catch(std::string& error)
   {
@@ -1023,3 +1939,139 @@ station_t DBInterface::getStation(coords_t location)
   }
   return {};
 }
+
+std::vector<coords_t> DBInterface::getStationLocations(const map_bounds_t& bounds)
+{
+  std::vector<coords_t> locations;
+  sql::query& q = statement(sql_select_station_locations_in_box)
+                  .arg(bounds.latitude.min)
+                  .arg(bounds.latitude.max)
+                  .arg(bounds.longitude.min)
+                  .arg(bounds.longitude.max);
+
+  while(!q.execute() && q.lastError() == SQLITE_BUSY);
+  assert(q.lastError() == SQLITE_DONE || q.lastError() == SQLITE_ROW);
+
+  while(q.fetchRow())
+  {
+    coords_t location;
+    q.getField(location.latitude)
+     .getField(location.longitude);
+    if(location.latitude  >= bounds.latitude.min  && location.latitude  <= bounds.latitude.max &&
+       location.longitude >= bounds.longitude.min && location.longitude <= bounds.longitude.max)
+      locations.push_back(location);
+  }
+  return locations;
+}
+
+// whole regions hydrate with one station query and a port query per batch_rows ports
+std::list<station_t> DBInterface::getStations(const map_bounds_t& bounds)
+{
+  std::vector<station_t> stations;
+  fetchStations(statement(sql_select_stations_in_box)
+                .arg(bounds.latitude.min)
+                .arg(bounds.latitude.max)
+                .arg(bounds.longitude.min)
+                .arg(bounds.longitude.max), stations);
+  hydratePorts(stations);
+  return { std::make_move_iterator(std::begin(stations)), std::make_move_iterator(std::end(stations)) };
+}
+
+// one query per batch_rows locations, stations come back in no particular order
+std::vector<station_t> DBInterface::getStations(std::span<const coords_t> locations)
+{
+  std::vector<station_t> stations;
+  for(std::size_t first = 0; first < locations.size(); first += batch_rows)
+  {
+    sql::query& q = statement(sql_select_stations_by_locations_batch);
+    for(std::size_t row = first; row < std::min(first + batch_rows, locations.size()); ++row)
+      q.arg(locations[row].latitude)
+       .arg(locations[row].longitude);
+    fetchStations(q, stations);
+  }
+  hydratePorts(stations);
+  return stations;
+}
+
+// grows a search box until the circle it encloses holds enough stations
+std::list<station_t> DBInterface::getNearestStations(coords_t location, std::size_t count)
+{
+  std::vector<std::pair<double, coords_t>> candidates;
+  const double scale = std::max(std::cos(location.latitude * std::numbers::pi / 180.0), 0.01); // longitude degrees shrink toward the poles
+  auto distance = [location, scale](coords_t pos) // the short way around, across the antimeridian if need be
+    { return std::hypot(pos.latitude - location.latitude, std::remainder(pos.longitude - location.longitude, 360.0) * scale); };
+
+  for(double radius = 0.05; count; radius *= 2.0)
+  {
+    const bool whole_map = radius >= 180.0;
+    const bound_t latitude(location.latitude - radius, location.latitude + radius);
+    const bound_t longitude(location.longitude - radius / scale, location.longitude + radius / scale);
+
+    std::vector<map_bounds_t> boxes; // a box that crosses the antimeridian is split in two
+    if(longitude.distance() >= 360.0)
+      boxes.emplace_back(latitude, bound_t(-180.0, 180.0));
+    else if(longitude.min < -180.0)
+      boxes = { { latitude, { longitude.min + 360.0, 180.0 } }, { latitude, { -180.0, longitude.max } } };
+    else if(longitude.max > 180.0)
+      boxes = { { latitude, { longitude.min, 180.0 } }, { latitude, { -180.0, longitude.max - 360.0 } } };
+    else
+      boxes.emplace_back(latitude, longitude);
+
+    candidates.clear();
+    for(const map_bounds_t& bounds : boxes)
+    {
+      for(const coords_t& pos : getStationLocations(bounds))
+      {
+        double from = distance(pos);
+        if(from <= radius || whole_map) // stations in the corners of the box may not be the nearest
+          candidates.emplace_back(from, pos);
+      }
+    }
+
+    if(candidates.size() >= count || whole_map)
+      break;
+  }
+
+  std::sort(std::begin(candidates), std::end(candidates),
+            [](const auto& a, const auto& b) { return a.first < b.first; });
+  if(candidates.size() > count)
+    candidates.resize(count);
+
+  std::vector<coords_t> nearest;
+  for(const auto& candidate : candidates)
+    nearest.push_back(candidate.second);
+
+  std::vector<station_t> stations = getStations(nearest);
+  std::sort(std::begin(stations), std::end(stations),
+            [&distance](const station_t& a, const station_t& b) { return distance(a.location) < distance(b.location); });
+  return { std::make_move_iterator(std::begin(stations)), std::make_move_iterator(std::end(stations)) };
+}
+
+// smallest covered cell of the network that fully contains bounds, with its cached listing
+std::optional<pair_data_t> DBInterface::getCoveringMapLocation(Network network_id, const map_bounds_t& bounds)
+{
+  std::optional<pair_data_t> return_data;
+  sql::query& q = statement(sql_select_covering_map_location)
+                  .arg(network_id)
+                  .arg(bounds.latitude.min)
+                  .arg(bounds.latitude.max)
+                  .arg(bounds.longitude.min)
+                  .arg(bounds.longitude.max);
+
+  while(!q.execute() && q.lastError() == SQLITE_BUSY);
+  assert(q.lastError() == SQLITE_DONE || q.lastError() == SQLITE_ROW);
+
+  if(q.fetchRow())
+  {
+    pair_data_t nd;
+    q.getField(nd.station.network_id)
+     .getField(nd.query.bounds.latitude.max)
+     .getField(nd.query.bounds.latitude.min)
+     .getField(nd.query.bounds.longitude.max)
+     .getField(nd.query.bounds.longitude.min)
+     .getField(nd.query.node_id)
+     .getField(nd.query.child_ids);
+    return_data.emplace(std::move(nd));
+  }
+  return return_data;
+}
@@ -1,9 +1,15 @@
 #ifndef DBINTERFACE_H
 #define DBINTERFACE_H
 
+#include <string>
 #include <string_view>
 #include <optional>
 #include <list>
+#include <chrono>
+#include <unordered_map>
+#include <functional>
+#include <vector>
+#include <span>
 #include <simplified/simple_sqlite.h>
 
 #include <scrapers/scraper_types.h>
@@ -11,9 +17,31 @@
 class DBInterface
 {
 public:
-  DBInterface(std::string_view filename);
+  struct cache_stats_t
+  {
+    std::string_view table;
+    std::size_t entries;
+    uint64_t hits;
+    uint64_t misses;
+  };
+
+  DBInterface(std::string_view filename, bool incremental = false); // incremental keeps the rows of earlier runs
   ~DBInterface(void);
 
+  // writes are grouped into transactions that commit every max_stations stations or max_age, whichever comes first
+  void setBatchLimits(std::size_t max_stations, std::chrono::milliseconds max_age);
+  void beginBatch(void);
+  void commitBatch(void);
+
+  // nodes fetched within age are skipped, zero refetches everything
+  void setRefreshAge(std::chrono::seconds age);
+  bool isFreshNode(std::string_view scraper, Parser parser, const std::string& node_id);
+  void addFetchedNode(std::string_view scraper, Parser parser, const std::string& node_id); // once its data is stored
+
+  // map areas known to be fully listed, requests inside a fresh one are redundant
+  void addCoveredArea(Network network_id, const map_bounds_t& bounds);
+  bool isCoveredArea(Network network_id, const map_bounds_t& bounds);
+
   void addMapLocation(const pair_data_t& data);
   void addUniqueString(const std::optional<std::string>& string);
   void addContact (const contact_t& contact);
@@ -21,6 +49,7 @@ public:
   void addPower   (const power_t& power);
   void addPort    (port_t& port); // fills in port.power.power_id and port.price.price_id
   void addStation (station_t& station); // fills in station.ports[].port_id and station.schedule.schedule_id
+  void addStations(std::span<station_t> stations); // addStation() for each, in one transaction with set-based statements
 
   std::optional<std::string> identifyMapLocation(const pair_data_t& data);
   std::optional<uint64_t> identifyUniqueString(const std::optional<std::string>& string);
@@ -38,9 +67,86 @@ public:
   station_t getStation(Network network_id, const std::string& station_id);
   station_t getStation(coords_t location);
 
+  // spatial lookups through the R*Tree indexes
+  std::list<station_t> getStations(const map_bounds_t& bounds);
+  std::vector<station_t> getStations(std::span<const coords_t> locations); // each location listed once
+  std::list<station_t> getNearestStations(coords_t location, std::size_t count);
+  std::optional<pair_data_t> getCoveringMapLocation(Network network_id, const map_bounds_t& bounds);
+
+  std::vector<cache_stats_t> cacheStats(void) const;
+
 private:
-  station_t getStation(sql::query&& q);
+  struct dimension_hash_t
+  {
+    std::size_t operator()(const power_t& power) const noexcept;
+    std::size_t operator()(const price_t& price) const noexcept;
+    std::size_t operator()(const contact_t& contact) const noexcept; // address fields only
+  };
+
+  struct address_equal_t // matches identifyContact(), which ignores phone_number and URL
+  {
+    bool operator()(const contact_t& a, const contact_t& b) const noexcept;
+  };
+
+  // row ids of deduplicated dimension rows, so repeated values never reach SQLite
+  template<typename T, typename Hash = dimension_hash_t, typename Equal = std::equal_to<T>>
+  struct id_cache_t
+  {
+    std::unordered_map<T, uint64_t, Hash, Equal> ids;
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+
+    std::optional<uint64_t> find(const T& key) noexcept
+    {
+      auto pos = ids.find(key);
+      if(pos == std::end(ids))
+        return ++misses, std::optional<uint64_t>();
+      return ++hits, pos->second;
+    }
+  };
+
+  void warmCaches(void);
+  std::vector<coords_t> getStationLocations(const map_bounds_t& bounds);
+
+  void batchWritten(std::size_t count = 1);
+  void execute(std::string_view command);
+  sql::query& statement(std::string_view sql); // prepared once per distinct SQL text
+
+  struct written_station_t // a merged station and the ids its row refers to
+  {
+    station_t* station = nullptr;
+    std::optional<uint64_t> contact_id;
+    std::optional<uint64_t> schedule_id;
+    bool conflicts = false;
+  };
+
+  written_station_t syncStation(station_t& station);
+  sql::query& bindPort(sql::query& q, port_t& port);
+  sql::query& bindStation(sql::query& q, const written_station_t& written);
+
+  station_t getStation(sql::query& q);
+  void fetchStations(sql::query& q, std::vector<station_t>& stations);
+  station_t readStation(sql::query& q);
+  void hydratePorts(std::span<station_t> stations);
   sql::db m_db;
+  struct statement_hash : std::hash<std::string_view> { using is_transparent = void; };
+  std::unordered_map<std::string, std::optional<sql::query>, statement_hash, std::equal_to<>> m_statements; // keyed by the SQL text
+
+  bool m_batch_open = false;
+  std::size_t m_batch_stations = 0;
+  std::size_t m_batch_max_stations = 1000;
+  std::chrono::milliseconds m_batch_max_age = std::chrono::milliseconds(5000);
+  std::chrono::steady_clock::time_point m_batch_start;
+  std::chrono::seconds m_refresh_age = std::chrono::seconds(0);
+  std::chrono::steady_clock::time_point m_opened = std::chrono::steady_clock::now();
+
+  id_cache_t<std::string, std::hash<std::string>> m_string_cache;
+  id_cache_t<contact_t, dimension_hash_t, address_equal_t> m_contact_cache;
+  id_cache_t<price_t> m_price_cache;
+  id_cache_t<power_t> m_power_cache;
+
+  uint64_t m_add_station_count = 0;
+  uint64_t m_add_station_us = 0;
 };
 
 #endif // DBINTERFACE_H
@@ -0,0 +1,352 @@
+#include "fetchengine.h"
+
+// STL
+#include <iostream>
+#include <algorithm>
+#include <optional>
+#include <chrono>
+
+// C
+#include <cctype>
+
+// project
+#include <scrapers/utilities.h>
+
+constexpr int max_retries = 3;
+
+static bool is_encoded(const response_headers_t& headers) noexcept
+{
+  return !headers.content_encoding.empty() && headers.content_encoding != "identity";
+}
+
+// keeps the headers of the final response, redirects start a new header block
+static std::size_t curl_header(char* data, std::size_t size, std::size_t nmemb, response_headers_t* headers)
+{
+  std::string_view line(data, size * nmemb);
+  auto value_of = [&line](std::string_view name) -> std::optional<std::string>
+  {
+    if(line.size() <= name.size() ||
+       !std::equal(std::begin(name), std::end(name), std::begin(line),
+                   [](char a, char b) { return std::tolower(static_cast<unsigned char>(a)) == std::tolower(static_cast<unsigned char>(b)); }))
+      return {};
+    std::string_view value = line.substr(name.size());
+    while(!value.empty() && std::isspace(static_cast<unsigned char>(value.front())))
+      value.remove_prefix(1);
+    while(!value.empty() && std::isspace(static_cast<unsigned char>(value.back())))
+      value.remove_suffix(1);
+    return std::string(value);
+  };
+
+  if(line.starts_with("HTTP/"))
+    *headers = response_headers_t();
+  else if(auto etag = value_of("etag:"); etag)
+    headers->etag = *etag;
+  else if(auto modified = value_of("last-modified:"); modified)
+    headers->last_modified = *modified;
+  else if(auto encoding = value_of("content-encoding:"); encoding)
+    headers->content_encoding = *encoding;
+  return size * nmemb;
+}
+
+static std::string host_from_url(const std::string& url)
+{
+  std::size_t start = url.find("://");
+  start = start == std::string::npos ? 0 : start + 3;
+  return url.substr(start, url.find('/', start) - start);
+}
+
+FetchEngine::FetchEngine(std::string_view name, std::size_t max_transfers, std::size_t max_host_transfers,
+                         ResponseCache* cache, element_sink_t element_sink)
+  : m_name(name),
+    m_max_transfers(std::max<std::size_t>(max_transfers, 1)),
+    m_max_host_transfers(std::max<std::size_t>(max_host_transfers, 1)),
+    m_multi(curl_multi_init()),
+    m_cache(cache),
+    m_element_sink(std::move(element_sink))
+{
+  curl_multi_setopt(m_multi, CURLMOPT_MAX_HOST_CONNECTIONS, long(m_max_host_transfers));
+  curl_multi_setopt(m_multi, CURLMOPT_MAX_TOTAL_CONNECTIONS, long(m_max_transfers));
+  curl_multi_setopt(m_multi, CURLMOPT_PIPELINING, long(CURLPIPE_MULTIPLEX));
+}
+
+FetchEngine::~FetchEngine(void)
+{
+  for(transfer_t* transfer : m_active)
+    curl_multi_remove_handle(m_multi, transfer->handle);
+  while(!m_active.empty())
+    finish(m_active.front());
+  for(transfer_t* transfer : m_pending)
+    delete transfer;
+  for(CURL* handle : m_idle_handles)
+    curl_easy_cleanup(handle);
+  curl_multi_cleanup(m_multi);
+}
+
+void FetchEngine::queue(pair_data_t data, bool stream)
+{
+  std::optional<cached_response_t> cached;
+  if(m_cache)
+    cached = m_cache->load(data.query);
+
+  if(m_cache && m_cache->offline())
+  {
+    if(cached)
+    {
+      ++m_cache->stats().replayed;
+      m_ready.push_back({ std::move(data), std::move(cached->body), fetch_status_t::replayed });
+    }
+    else
+    {
+      ++m_cache->stats().missing;
+      std::cout << "not cached: " << data.query.URL << std::endl;
+      m_ready.push_back({ std::move(data), std::string(), fetch_status_t::missing });
+    }
+    return;
+  }
+
+  transfer_t* transfer = new transfer_t;
+  transfer->host = host_from_url(data.query.URL);
+  transfer->data = std::move(data);
+  transfer->cached = std::move(cached);
+  if(stream && m_element_sink)
+  {
+    transfer->stream = true;
+    transfer->splitter = std::make_unique<json_splitter>(
+                           [this, transfer](std::string_view element) { m_element_sink(transfer->data, element); });
+    transfer->keep_body = m_cache != nullptr;
+  }
+  m_pending.push_back(transfer);
+  launch_pending();
+}
+
+void FetchEngine::launch_pending(void)
+{
+  for(auto pos = std::begin(m_pending); pos != std::end(m_pending);)
+  {
+    if(m_host_count[(*pos)->host] < m_max_host_transfers)
+    {
+      start(*pos);
+      pos = m_pending.erase(pos);
+    }
+    else
+      ++pos;
+  }
+}
+
+void FetchEngine::start(transfer_t* transfer)
+{
+  const query_info_t& query = transfer->data.query;
+
+  if(!transfer->handle)
+  {
+    if(m_idle_handles.empty())
+    {
+      transfer->handle = curl_easy_init();
+      curl_easy_setopt(transfer->handle, CURLOPT_USERAGENT, "Mozilla/5.0 (X11; Linux x86_64; rv:81.0) Gecko/20100101 Firefox/81.0");
+      curl_easy_setopt(transfer->handle, CURLOPT_TCP_KEEPALIVE, 1L);
+      curl_easy_setopt(transfer->handle, CURLOPT_WRITEFUNCTION, receive);
+      curl_easy_setopt(transfer->handle, CURLOPT_HEADERFUNCTION, curl_header);
+      curl_easy_setopt(transfer->handle, CURLOPT_FOLLOWLOCATION, 1L);
+    }
+    else
+    {
+      transfer->handle = m_idle_handles.back();
+      m_idle_handles.pop_back();
+    }
+
+    for(const auto& pair : query.header_fields)
+      transfer->headers = curl_slist_append(transfer->headers, (pair.first + ": " + pair.second).c_str());
+    transfer->headers = curl_slist_append(transfer->headers, "Accept-Encoding: gzip, deflate"); // decoded by decode()
+
+    if(transfer->cached) // revalidate instead of downloading again
+    {
+      if(!transfer->cached->etag.empty())
+        transfer->headers = curl_slist_append(transfer->headers, ("If-None-Match: " + transfer->cached->etag).c_str());
+      if(!transfer->cached->last_modified.empty())
+        transfer->headers = curl_slist_append(transfer->headers, ("If-Modified-Since: " + transfer->cached->last_modified).c_str());
+    }
+
+    curl_easy_setopt(transfer->handle, CURLOPT_PRIVATE, transfer);
+    curl_easy_setopt(transfer->handle, CURLOPT_WRITEDATA, transfer);
+    curl_easy_setopt(transfer->handle, CURLOPT_HEADERDATA, &transfer->response);
+    curl_easy_setopt(transfer->handle, CURLOPT_HTTPHEADER, transfer->headers);
+    curl_easy_setopt(transfer->handle, CURLOPT_URL, query.URL.c_str());
+
+    if(query.post_data.empty())
+      curl_easy_setopt(transfer->handle, CURLOPT_HTTPGET, 1L);
+    else
+    {
+      curl_easy_setopt(transfer->handle, CURLOPT_POSTFIELDSIZE, long(query.post_data.size()));
+      curl_easy_setopt(transfer->handle, CURLOPT_POSTFIELDS, query.post_data.c_str());
+    }
+
+    ++m_host_count[transfer->host];
+    m_active.push_back(transfer);
+  }
+
+  std::cout << "requesting: " << query.URL << std::endl;
+  if(!query.post_data.empty())
+    std::cout << "  with post data: " << query.post_data << std::endl;
+
+  curl_multi_add_handle(m_multi, transfer->handle);
+}
+
+// plain bodies are split while downloading, encoded ones are buffered and split once decoded
+std::size_t FetchEngine::receive(char* data, std::size_t size, std::size_t nmemb, transfer_t* transfer)
+{
+  std::string_view chunk(data, size * nmemb);
+  transfer->received += chunk.size();
+  if(transfer->splitter && !is_encoded(transfer->response))
+  {
+    if(!transfer->splitter->feed(chunk)) // not an array, leave it to Parse()
+      transfer->splitter.reset();
+    else if(!transfer->keep_body)
+      return chunk.size();
+  }
+  transfer->body.append(chunk);
+  return chunk.size();
+}
+
+// downloads again from scratch on the same handle and connection slot, gives up after max_retries
+void FetchEngine::retry(transfer_t* transfer, std::vector<fetch_result_t>& results)
+{
+  if(transfer->retries >= max_retries)
+  {
+    std::cerr << "scraper: " << m_name << std::endl
+              << "giving up after " << transfer->retries << " retries on: " << transfer->data.query.URL << std::endl;
+    ++m_stats.failed;
+    results.push_back({ std::move(transfer->data), std::string(), fetch_status_t::failed });
+    finish(transfer);
+    return;
+  }
+
+  transfer->body.clear();
+  transfer->received = 0;
+  transfer->response = response_headers_t();
+  if(transfer->stream) // elements already delivered are sent again, storing them is idempotent
+    transfer->splitter = std::make_unique<json_splitter>(
+                           [this, transfer](std::string_view element) { m_element_sink(transfer->data, element); });
+  std::cout << "retry #" << ++transfer->retries << std::endl;
+  start(transfer);
+}
+
+void FetchEngine::finish(transfer_t* transfer)
+{
+  curl_slist_free_all(transfer->headers);
+  --m_host_count[transfer->host];
+  m_active.remove(transfer);
+  m_idle_handles.push_back(transfer->handle);
+  delete transfer;
+}
+
+void FetchEngine::collect(std::vector<fetch_result_t>& results)
+{
+  int running = 0;
+  curl_multi_perform(m_multi, &running);
+
+  int remaining = 0;
+  while(CURLMsg* msg = curl_multi_info_read(m_multi, &remaining))
+  {
+    if(msg->msg != CURLMSG_DONE)
+      continue;
+
+    transfer_t* transfer = nullptr;
+    CURLcode error = msg->data.result;
+    curl_easy_getinfo(msg->easy_handle, CURLINFO_PRIVATE, &transfer);
+    curl_multi_remove_handle(m_multi, transfer->handle);
+
+    if(error != CURLE_OK && error != CURLE_REMOTE_ACCESS_DENIED)
+    {
+      std::cerr << "scraper: " << m_name << std::endl
+                << "node id: " << transfer->data.query.node_id << std::endl
+                << "name: " << transfer->data.station.name << std::endl
+                << "error: " << error << std::endl;
+    }
+
+    long response_code = 0;
+    curl_easy_getinfo(transfer->handle, CURLINFO_RESPONSE_CODE, &response_code);
+
+    if(error == CURLE_OK && response_code == 304 && transfer->cached)
+    {
+      ++m_cache->stats().not_modified;
+      results.push_back({ std::move(transfer->data), std::move(transfer->cached->body), fetch_status_t::not_modified });
+      finish(transfer);
+    }
+    else if(error != CURLE_OK || !transfer->received) // a cut short body is never cached nor parsed
+      retry(transfer, results);
+    else if(!decode(transfer)) // the same bytes would come back, so this is final
+    {
+      std::cerr << "scraper: " << m_name << std::endl
+                << "undecodable " << transfer->response.content_encoding << " body from: " << transfer->data.query.URL << std::endl;
+      ++m_stats.failed;
+      results.push_back({ std::move(transfer->data), std::string(), fetch_status_t::failed });
+      finish(transfer);
+    }
+    else
+    {
+      if(transfer->splitter && is_encoded(transfer->response) && !transfer->splitter->feed(transfer->body))
+        transfer->splitter.reset();
+
+      if(transfer->splitter && !transfer->splitter->complete()) // the array never closed
+      {
+        std::cerr << "scraper: " << m_name << std::endl
+                  << "stream cut short after " << transfer->splitter->elements() << " elements from: " << transfer->data.query.URL << std::endl;
+        retry(transfer, results);
+        continue;
+      }
+
+      if(m_cache && response_code == 200)
+      {
+        cached_response_t entry { transfer->response.etag, transfer->response.last_modified, std::move(transfer->body) };
+        m_cache->store(transfer->data.query, entry);
+        transfer->body = std::move(entry.body);
+      }
+
+      if(transfer->splitter)
+        results.push_back({ std::move(transfer->data), std::string(), fetch_status_t::streamed });
+      else
+        results.push_back({ std::move(transfer->data), std::move(transfer->body) });
+      finish(transfer);
+    }
+  }
+
+  launch_pending();
+}
+
+// tinf has no streaming interface, so the body is decoded whole once the transfer completes
+bool FetchEngine::decode(transfer_t* transfer)
+{
+  m_stats.wire_bytes += transfer->received;
+  const std::string& encoding = transfer->response.content_encoding;
+  if(!is_encoded(transfer->response))
+    m_stats.body_bytes += transfer->received;
+  else
+  {
+    auto start = std::chrono::steady_clock::now();
+    std::optional<std::string> decoded;
+    if(encoding == "gzip" || encoding == "x-gzip")
+      decoded = ext::gunzip(transfer->body);
+    else if(encoding == "deflate")
+      decoded = ext::inflate(transfer->body);
+    m_stats.decode_us += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+    if(!decoded)
+      return false;
+    transfer->body = std::move(*decoded);
+    m_stats.body_bytes += transfer->body.size();
+  }
+  return true;
+}
+
+std::vector<fetch_result_t> FetchEngine::wait(int timeout_ms)
+{
+  std::vector<fetch_result_t> results;
+  results.swap(m_ready);
+  collect(results);
+  if(results.empty() && !m_active.empty())
+  {
+    curl_multi_poll(m_multi, nullptr, 0, timeout_ms, nullptr);
+    collect(results);
+  }
+  return results;
+}
@@ -0,0 +1,113 @@
+#ifndef FETCHENGINE_H
+#define FETCHENGINE_H
+
+#include <string>
+#include <string_view>
+#include <list>
+#include <vector>
+#include <unordered_map>
+#include <functional>
+#include <memory>
+
+#include <curl/curl.h>
+
+#include <scrapers/scraper_types.h>
+
+#include "responsecache.h"
+#include "jsonsplitter.h"
+
+enum class fetch_status_t
+{
+  downloaded,
+  not_modified, // body is the cached copy the server revalidated
+  replayed,     // body is the cached copy, served offline
+  missing,      // offline and never cached, body is empty
+  streamed,     // every element already went to the element sink, body is empty
+  failed,       // the response was unusable and will not be retried, body is empty
+};
+
+using element_sink_t = std::function<void(const pair_data_t& data, std::string_view element)>;
+
+struct response_headers_t
+{
+  std::string etag;
+  std::string last_modified;
+  std::string content_encoding;
+};
+
+struct fetch_stats_t
+{
+  uint64_t wire_bytes = 0; // as received, before content decoding
+  uint64_t body_bytes = 0;
+  uint64_t decode_us = 0;
+  uint64_t failed = 0; // transfers given up on
+};
+
+struct fetch_result_t
+{
+  pair_data_t data;
+  std::string body;
+  fetch_status_t status = fetch_status_t::downloaded;
+};
+
+// drives many transfers at once on a single curl multi handle
+class FetchEngine
+{
+public:
+  FetchEngine(std::string_view name, std::size_t max_transfers, std::size_t max_host_transfers,
+              ResponseCache* cache = nullptr, element_sink_t element_sink = nullptr);
+  ~FetchEngine(void);
+
+  bool idle(void) const noexcept { return m_active.empty() && m_pending.empty() && m_ready.empty(); }
+  bool full(void) const noexcept { return queued() >= m_max_transfers; }
+  std::size_t capacity(void) const noexcept { return full() ? 0 : m_max_transfers - queued(); }
+
+  void queue(pair_data_t data, bool stream = false); // data must have been through ScraperBase::BuildQuery
+                                                            // stream splits a JSON array body into elements as it arrives
+  std::vector<fetch_result_t> wait(int timeout_ms = 1000); // waits up to timeout_ms for transfers to complete
+  void wakeup(void) noexcept { curl_multi_wakeup(m_multi); } // interrupts wait(), safe from any thread
+  const fetch_stats_t& stats(void) const noexcept { return m_stats; }
+
+private:
+  struct transfer_t
+  {
+    CURL* handle = nullptr;
+    curl_slist* headers = nullptr;
+    pair_data_t data;
+    std::string body;
+    std::string host;
+    int retries = 0;
+    std::optional<cached_response_t> cached;
+    response_headers_t response;
+    std::unique_ptr<json_splitter> splitter;
+    bool stream = false;
+    std::size_t received = 0;
+    bool keep_body = true; // a streamed body is only kept for the cache
+  };
+
+  static std::size_t receive(char* data, std::size_t size, std::size_t nmemb, transfer_t* transfer);
+
+  std::size_t queued(void) const noexcept { return m_active.size() + m_pending.size() + m_ready.size(); }
+
+  void start(transfer_t* transfer);
+  void retry(transfer_t* transfer, std::vector<fetch_result_t>& results);
+  void finish(transfer_t* transfer);
+  void launch_pending(void);
+  void collect(std::vector<fetch_result_t>& results);
+  bool decode(transfer_t* transfer);
+
+  std::string m_name;
+  std::size_t m_max_transfers;
+  std::size_t m_max_host_transfers;
+  CURLM* m_multi;
+  std::vector<CURL*> m_idle_handles; // reused so connections and DNS lookups stay warm
+  std::list<transfer_t*> m_pending;  // waiting on a per-host slot
+  std::list<transfer_t*> m_active;
+  std::vector<fetch_result_t> m_ready; // answered from the cache without a transfer
+  ResponseCache* m_cache;
+  element_sink_t m_element_sink;
+  fetch_stats_t m_stats;
+  std::unordered_map<std::string, std::size_t> m_host_count;
+};
+
+#endif // FETCHENGINE_H
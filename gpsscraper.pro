@@ -4,6 +4,7 @@ CONFIG += c++2a
 CONFIG += strict_c++
 #CONFIG += exceptions_off
 CONFIG += rtti_off
+CONFIG += thread
 
 CONFIG -= app_bundle
 CONFIG -= qt
@@ -11,13 +12,15 @@ CONFIG -= qt
 #clang:CONFIG += win32
 
 #DEFINES += DATABASE_TOLERANT
+#DEFINES += COUNT_ALLOCATIONS # report heap allocations per parsed and stored batch
+#DEFINES += COUNT_COPIES # report pair_data_t copies per fetched, parsed and stored record
 
 #QMAKE_CXXFLAGS_DEBUG += -DDEBUG_BUILD
 QMAKE_CXXFLAGS_DEBUG += -O0
 QMAKE_CXXFLAGS_RELEASE += -Os
 #QMAKE_CXXFLAGS += -Os
 #QMAKE_CXXFLAGS += -ffreestanding
-QMAKE_CXXFLAGS += -fno-threadsafe-statics
+#QMAKE_CXXFLAGS += -fno-threadsafe-statics # parsers run on a thread pool
 #linux:QMAKE_LFLAGS += -L/usr/lib/x86_64-linux-musl
 #linux:QMAKE_LFLAGS += -lc
 
@@ -30,8 +33,14 @@ PKGCONFIG += sqlite3
 
 
 SOURCES += \
+        alloccounter.cpp \
+        crawler.cpp \
         dbinterface.cpp \
+        fetchengine.cpp \
+        idset.cpp \
+        jsonsplitter.cpp \
         main.cpp \
+        responsecache.cpp \
         scrapers/chargehub.cpp \
         scrapers/echarge.cpp \
         scrapers/electrifyamerica.cpp \
@@ -40,6 +49,7 @@ SOURCES += \
         scrapers/scraper_types.cpp \
         scrapers/utilities.cpp \
         scrapers/scraper_base.cpp \
+        workscheduler.cpp \
         shortjson/shortjson_tolerant.cpp \
         simplified/simple_sqlite.cpp \
         tinf/src/adler32.c \
@@ -49,8 +59,17 @@ SOURCES += \
         tinf/src/tinfzlib.c
 
 HEADERS += \
+  alloccounter.h \
+  boundedqueue.h \
+  crawler.h \
   dbinterface.h \
+  fetchengine.h \
+  idset.h \
+  jsonsplitter.h \
+  responsecache.h \
+  ringqueue.h \
   scrapers/chargehub.h \
+  scrapers/chargehub_matchers.h \
   scrapers/echarge.h \
   scrapers/electrifyamerica.h \
   scrapers/eptix.h \
@@ -58,6 +77,7 @@ HEADERS += \
   scrapers/scraper_types.h \
   scrapers/utilities.h \
   scrapers/scraper_base.h \
+  workscheduler.h \
   shortjson/shortjson.h \
   simplified/simple_curl.h \
   simplified/simple_sqlite.h \
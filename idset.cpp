@@ -0,0 +1,140 @@
+#include "idset.h"
+
+// STL
+#include <algorithm>
+#include <utility>
+
+// the splitmix64 finalizer, sequential ids land far apart
+static uint64_t mix(uint64_t value) noexcept
+{
+  value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9;
+  value = (value ^ (value >> 27)) * 0x94d049bb133111eb;
+  return value ^ (value >> 31);
+}
+
+static uint64_t mix(const auto& uuid) noexcept
+{
+  return mix(uuid.high ^ mix(uuid.low));
+}
+
+static int hex_value(char c) noexcept
+{
+  if(c >= '0' && c <= '9')
+    return c - '0';
+  if(c >= 'a' && c <= 'f')
+    return c - 'a' + 10;
+  return -1; // uppercase too, "ABC" and "abc" must stay distinct ids
+}
+
+template<typename Key, Key empty>
+bool id_set::flat_table<Key, empty>::insert(Key key)
+{
+  if((count + 1) * 2 > slots.size()) // grow before probing, keeps every probe sequence short
+  {
+    std::vector<Key> old(std::max<std::size_t>(slots.size() * 2, 64), empty);
+    std::swap(slots, old);
+    std::size_t mask = slots.size() - 1;
+    for(const Key& moved : old)
+      if(!(moved == empty))
+      {
+        std::size_t pos = mix(moved) & mask;
+        while(!(slots[pos] == empty))
+          pos = (pos + 1) & mask;
+        slots[pos] = moved;
+      }
+  }
+
+  std::size_t mask = slots.size() - 1;
+  for(std::size_t pos = mix(key) & mask;; pos = (pos + 1) & mask)
+  {
+    if(slots[pos] == key)
+      return false;
+    if(slots[pos] == empty)
+    {
+      slots[pos] = key;
+      ++count;
+      return true;
+    }
+  }
+}
+
+template<typename Key, Key empty>
+bool id_set::flat_table<Key, empty>::contains(Key key) const noexcept
+{
+  if(slots.empty())
+    return false;
+  std::size_t mask = slots.size() - 1;
+  for(std::size_t pos = mix(key) & mask;; pos = (pos + 1) & mask)
+  {
+    if(slots[pos] == key)
+      return true;
+    if(slots[pos] == empty)
+      return false;
+  }
+}
+
+// canonical decimal only, "007" and "7" are different ids
+std::optional<uint64_t> id_set::to_number(std::string_view id) noexcept
+{
+  if(id.empty() || id.size() > 19 || (id.front() == '0' && id.size() > 1))
+    return {};
+  uint64_t value = 0;
+  for(char c : id)
+  {
+    if(c < '0' || c > '9')
+      return {};
+    value = value * 10 + uint64_t(c - '0');
+  }
+  return value; // at most 19 digits, never the empty marker
+}
+
+// lowercase 8-4-4-4-12 form only, so every accepted key maps back to exactly one string
+std::optional<id_set::uuid_t> id_set::to_uuid(std::string_view id) noexcept
+{
+  if(id.size() != 36)
+    return {};
+  uuid_t uuid = { 0, 0 };
+  std::size_t digits = 0;
+  for(std::size_t i = 0; i < id.size(); ++i)
+  {
+    if(i == 8 || i == 13 || i == 18 || i == 23)
+    {
+      if(id[i] != '-')
+        return {};
+      continue;
+    }
+    int value = hex_value(id[i]);
+    if(value < 0)
+      return {};
+    uint64_t& half = digits++ < 16 ? uuid.high : uuid.low;
+    half = (half << 4) | uint64_t(value);
+  }
+  if(uuid == uuid_t { ~uint64_t(0), ~uint64_t(0) }) // the empty marker itself
+    return {};
+  return uuid;
+}
+
+bool id_set::insert(std::string_view id)
+{
+  if(auto number = to_number(id); number)
+    return m_numbers.insert(*number);
+  if(auto uuid = to_uuid(id); uuid)
+    return m_uuids.insert(*uuid);
+  return m_others.emplace(id).second;
+}
+
+bool id_set::contains(std::string_view id) const
+{
+  if(auto number = to_number(id); number)
+    return m_numbers.contains(*number);
+  if(auto uuid = to_uuid(id); uuid)
+    return m_uuids.contains(*uuid);
+  return m_others.contains(std::string(id));
+}
+
+std::size_t id_set::memory(void) const noexcept
+{
+  return m_numbers.slots.capacity() * sizeof(uint64_t) +
+         m_uuids.slots.capacity() * sizeof(uuid_t) +
+         m_others.bucket_count() * sizeof(void*);
+}
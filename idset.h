@@ -0,0 +1,51 @@
+#ifndef IDSET_H
+#define IDSET_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_set>
+#include <optional>
+
+#include <cstdint>
+
+// set of remote record ids specialized for the forms scrapers actually see
+// decimal ids are kept as 64-bit integers and lowercase UUIDs as 128-bit keys, each in an
+// open-addressing table, anything else falls back to a set of strings
+class id_set
+{
+public:
+  bool insert(std::string_view id); // true if the id was not already present
+  bool contains(std::string_view id) const;
+
+  std::size_t size(void) const noexcept { return m_numbers.count + m_uuids.count + m_others.size(); }
+  std::size_t memory(void) const noexcept; // approximate bytes held, excluding the fallback's nodes
+
+private:
+  struct uuid_t
+  {
+    uint64_t high;
+    uint64_t low;
+    constexpr bool operator ==(const uuid_t& other) const noexcept = default;
+  };
+
+  // linear probing, never more than half full, empty slots hold the one key that cannot be parsed into
+  template<typename Key, Key empty>
+  struct flat_table
+  {
+    std::vector<Key> slots;
+    std::size_t count = 0;
+
+    bool insert(Key key);
+    bool contains(Key key) const noexcept;
+  };
+
+  static std::optional<uint64_t> to_number(std::string_view id) noexcept;
+  static std::optional<uuid_t> to_uuid(std::string_view id) noexcept;
+
+  flat_table<uint64_t, ~uint64_t(0)> m_numbers;
+  flat_table<uuid_t, uuid_t { ~uint64_t(0), ~uint64_t(0) }> m_uuids;
+  std::unordered_set<std::string> m_others;
+};
+
+#endif // IDSET_H
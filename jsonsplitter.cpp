@@ -0,0 +1,118 @@
+#include "jsonsplitter.h"
+
+// C
+#include <cctype>
+
+json_splitter::json_splitter(element_handler_t handler)
+  : m_handler(std::move(handler))
+{
+}
+
+void json_splitter::emit(void)
+{
+  if(!m_element.empty())
+  {
+    m_handler(m_element);
+    ++m_elements;
+  }
+  m_element.clear();
+  m_depth = 0;
+  m_state = state_t::between_elements;
+}
+
+bool json_splitter::feed(std::string_view chunk)
+{
+  for(char c : chunk)
+  {
+    bool space = std::isspace(static_cast<unsigned char>(c));
+    switch(m_state)
+    {
+      case state_t::done:
+        continue;
+
+      case state_t::failed:
+        return false;
+
+      case state_t::before_array:
+        if(c == '[')
+          m_state = state_t::between_elements;
+        else if(!space)
+        {
+          m_state = state_t::failed;
+          return false;
+        }
+        continue;
+
+      case state_t::between_elements:
+        if(space || c == ',')
+          continue;
+        if(c == ']')
+        {
+          m_state = state_t::done;
+          continue;
+        }
+        m_state = state_t::in_element;
+        break; // first byte of the element
+
+      case state_t::in_element:
+        break;
+    }
+
+    if(m_in_string)
+    {
+      m_element.push_back(c);
+      if(m_escaped)
+        m_escaped = false;
+      else if(c == '\\')
+        m_escaped = true;
+      else if(c == '"')
+      {
+        m_in_string = false;
+        if(!m_depth) // the element was a string
+          emit();
+      }
+      continue;
+    }
+
+    switch(c)
+    {
+      case '"':
+        m_in_string = true;
+        m_element.push_back(c);
+        break;
+
+      case '{':
+      case '[':
+        ++m_depth;
+        m_element.push_back(c);
+        break;
+
+      case '}':
+      case ']':
+        if(!m_depth) // end of the array closes a scalar element
+        {
+          emit();
+          m_state = state_t::done;
+          break;
+        }
+        m_element.push_back(c);
+        if(!--m_depth)
+          emit();
+        break;
+
+      case ',':
+        if(!m_depth) // end of a scalar element
+          emit();
+        else
+          m_element.push_back(c);
+        break;
+
+      default:
+        if(space && !m_depth)
+          emit();
+        else
+          m_element.push_back(c);
+    }
+  }
+  return true;
+}
@@ -0,0 +1,42 @@
+#ifndef JSONSPLITTER_H
+#define JSONSPLITTER_H
+
+#include <string>
+#include <string_view>
+#include <functional>
+
+// cuts a top-level JSON array into its elements as the bytes arrive
+// only the element in progress is buffered, elements are not validated
+class json_splitter
+{
+public:
+  using element_handler_t = std::function<void(std::string_view element)>;
+
+  json_splitter(element_handler_t handler);
+
+  bool feed(std::string_view chunk); // false once the input turns out not to be an array
+  bool complete(void) const noexcept { return m_state == state_t::done; }
+  std::size_t elements(void) const noexcept { return m_elements; }
+
+private:
+  enum class state_t
+  {
+    before_array,
+    between_elements,
+    in_element,
+    done,
+    failed,
+  };
+
+  void emit(void);
+
+  element_handler_t m_handler;
+  state_t m_state = state_t::before_array;
+  std::string m_element;
+  std::size_t m_depth = 0;
+  std::size_t m_elements = 0;
+  bool m_in_string = false;
+  bool m_escaped = false;
+};
+
+#endif // JSONSPLITTER_H
@@ -8,13 +8,15 @@
 #include <memory>
 #include <unordered_set>
 #include <fstream>
+#include <thread>
+#include <chrono>
 
 #include <cctype>
 #include <cassert>
 #include <cmath>
 
 #include <simplified/simple_sqlite.h>
-#include <simplified/simple_curl.h>
+#include <curl/curl.h>
 
 //#include "cookie_calculator.h"
 
@@ -28,65 +30,17 @@
 #include <unistd.h>
 
 #include "dbinterface.h"
+#include "crawler.h"
+#include "responsecache.h"
 
 using namespace std::string_literals;
 constexpr std::string_view dbfile = "stations.db";
-
-
-std::size_t curl_to_string(char* data, std::size_t size, std::size_t nmemb, std::string* string)
-{
-  if (!string)
-    return 0;
-  string->append(data, size * nmemb);
-  return size * nmemb;
-}
-
-static SimpleCurl& static_request(void)
-{
-  static SimpleCurl request;
-  static bool have_init = false;
-  if(!have_init)
-  {
-    have_init = true;
-    request.reset();
-    request.setOpt(CURLOPT_USERAGENT, "Mozilla/5.0 (X11; Linux x86_64; rv:81.0) Gecko/20100101 Firefox/81.0");
-    request.setOpt(CURLOPT_TCP_KEEPALIVE, 1);
-    request.setOpt(CURLOPT_WRITEFUNCTION, curl_to_string);
-    request.setOpt(CURLOPT_FOLLOWLOCATION, 1);
-  }
-  return request;
-}
-
-std::string get_page(const std::string_view& name, const pair_data_t& data)
-{
-  std::string output;
-  auto& request = static_request();
-  request.setOpt(CURLOPT_WRITEDATA, &output);
-
-  request.setOpt(CURLOPT_POST, !data.query.post_data.empty());
-
-  if(!data.query.post_data.empty())
-    request.setOpt(CURLOPT_POSTFIELDS, data.query.post_data);
-
-  request.clearHeaderFields();
-  for(const auto& pair : data.query.header_fields)
-    request.setHeaderField(pair.first, pair.second);
-
-  std::cout << "requesting: " << data.query.URL << std::endl;
-  if(!data.query.post_data.empty())
-    std::cout << "  with post data: " << data.query.post_data << std::endl;
-
-  if((!request.setOpt(CURLOPT_URL, data.query.URL) ||
-      !request.perform()) &&
-     request.getLastError() != CURLE_REMOTE_ACCESS_DENIED)
-  {
-    std::cerr << "scraper: " << name << std::endl
-              << "node id: " << data.query.node_id << std::endl
-              << "name: " << data.station.name << std::endl
-              << "error: " << request.getLastError() << std::endl;
-  }
-  return output;
-}
+constexpr std::size_t default_max_transfers = 32;
+constexpr std::size_t default_max_host_transfers = 8;
+constexpr std::size_t default_queue_depth = 256;
+constexpr std::size_t default_batch_size = 1000;
+constexpr std::chrono::milliseconds default_batch_age(5000);
+constexpr std::string_view default_cache_dir = "http_cache";
 
 
 void append_line(std::optional<std::string>& target, const std::string_view& data)
@@ -150,18 +104,73 @@ int main(int argc, char* argv[])
 
   scraper_list.sort([](const scraper_t& a, const scraper_t& b) noexcept { return a.first < b.first; });
 
-  if(argc > 1)
+  crawl_options_t options;
+  options.max_transfers = default_max_transfers;
+  options.max_host_transfers = default_max_host_transfers;
+  options.parser_threads = std::max(std::thread::hardware_concurrency(), 3U) - 2;
+  options.queue_depth = default_queue_depth;
+  std::list<std::string_view> selected_scrapers;
+  bool parallel = false;
+  bool incremental = false;
+  std::chrono::hours refresh_age(0);
+  std::optional<std::string> cache_dir;
+  bool offline = false;
+  std::size_t batch_size = default_batch_size;
+  std::chrono::milliseconds batch_age = default_batch_age;
+
+  for(int i = 1; i < argc; ++i)
+  {
+    ext::string arg = argv[i];
+    if(!arg.starts_with("--"))
+      selected_scrapers.emplace_back(argv[i]);
+    else if(arg == "--parallel")
+      parallel = true;
+    else if(arg == "--incremental")
+      incremental = true;
+    else if(arg.starts_with("--ttl-hours="))
+      refresh_age = std::chrono::hours(ext::from_string<unsigned long>(arg.substr(arg.find('=') + 1)));
+    else if(arg == "--cache")
+      cache_dir = default_cache_dir;
+    else if(arg.starts_with("--cache="))
+      cache_dir = arg.substr(arg.find('=') + 1);
+    else if(arg == "--offline") // replay cached responses only
+      offline = true;
+    else if(arg.starts_with("--batch-size="))
+      batch_size = ext::from_string<unsigned long>(arg.substr(arg.find('=') + 1));
+    else if(arg.starts_with("--batch-ms="))
+      batch_age = std::chrono::milliseconds(ext::from_string<unsigned long>(arg.substr(arg.find('=') + 1)));
+    else if(arg.starts_with("--transfers="))
+      options.max_transfers = ext::from_string<unsigned long>(arg.substr(arg.find('=') + 1));
+    else if(arg.starts_with("--host-transfers="))
+      options.max_host_transfers = ext::from_string<unsigned long>(arg.substr(arg.find('=') + 1));
+    else if(arg.starts_with("--parsers="))
+      options.parser_threads = ext::from_string<unsigned long>(arg.substr(arg.find('=') + 1));
+    else if(arg.starts_with("--queue-depth="))
+      options.queue_depth = ext::from_string<unsigned long>(arg.substr(arg.find('=') + 1));
+    else if(arg.starts_with("--schedule=")) // fifo, kind, depth or locality
+    {
+      auto policy = to_schedule_policy(arg.substr(arg.find('=') + 1));
+      if(!policy)
+      {
+        std::cerr << "Unknown schedule: " << arg << std::endl;
+        return EXIT_FAILURE;
+      }
+      options.schedule = *policy;
+    }
+    else
+    {
+      std::cerr << "Unknown option: " << arg << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  if(!selected_scrapers.empty())
   {
     auto pos = std::begin(scraper_list);
     auto end = std::end(scraper_list);
     while(pos != end)
     {
-      bool found = false;
-      for(int i = 1; i < argc; ++i)
-        if(pos->first == argv[i])
-          found = true;
-
-      if(found)
+      if(std::find(std::begin(selected_scrapers), std::end(selected_scrapers), pos->first) != std::end(selected_scrapers))
         ++pos;
       else
       {
@@ -183,142 +192,64 @@ int main(int argc, char* argv[])
       std::cerr << pair.first << ", ";
     std::cerr << std::endl;
 
-    DBInterface db(dbfile);
+    std::unique_ptr<ResponseCache> cache;
+    if(cache_dir || offline)
+      cache = std::make_unique<ResponseCache>(cache_dir.value_or(std::string(default_cache_dir)), offline);
+    options.cache = cache.get();
+    options.skip_unchanged = incremental;
+
+    DBInterface db(dbfile, incremental);
+    db.setBatchLimits(batch_size, batch_age);
+    if(incremental)
+      db.setRefreshAge(refresh_age);
 
     uintptr_t total_insertions = 0;
     uintptr_t insertion_count = 0;
 
     try
     {
-      for(auto& scraper : scraper_list)
+      auto run_crawlers = [&](std::list<scraper_t>::iterator first, std::list<scraper_t>::iterator last)
       {
-        insertion_count = 0;
-        std::list<pair_data_t> main_queue;
-        std::cout << scraper.first << ": scraper active" << std::endl;
-
-        //static_request().setOpt(CURLOPT_COOKIE, ""); // erase all cookies and enable cookies
+        std::list<Crawler> crawlers;
+        for(auto pos = first; pos != last; ++pos)
         {
-          pair_data_t nd;
-          nd.query.parser = Parser::BuildQuery | Parser::Initial;
-          nd.query.node_id = "root";
-          main_queue.emplace_back(nd);
+          std::cout << pos->first << ": scraper active" << std::endl;
+          crawlers.emplace_back(pos->first, pos->second, db, options);
         }
 
-        std::unordered_set<std::string> station_nodes, port_nodes; // used to avoid duplicate requests
-        for(;!main_queue.empty(); main_queue.pop_front())
-        {
-          auto& pos = main_queue.front();
-          std::cout << "queue size: " << main_queue.size() << std::endl;
-
-          if((pos.query.parser & Parser::BuildQuery) == Parser::BuildQuery)
-          {
-            pos = scraper.second->BuildQuery(pos);
-          }
-          std::string result;
-          if(pos.query.parser != Parser::Initial)
-          {
-            for(int i = 0; result.empty(); ++i)
-            {
-              if(i)
-                std::cout << "retry #" << i << std::endl;
-              result = get_page(scraper.first, pos);
-            }
-          }
-
-          std::list<pair_data_t> test_queue;
-          {
-            std::vector<pair_data_t> tmp = scraper.second->Parse(pos, result);
-            test_queue = { std::begin(tmp), std::end(tmp) };
-          }
-          std::cout << "result count: " << test_queue.size() << std::endl;
+        crawl(crawlers, options.queue_depth);
+        db.commitBatch();
 
-          for(;!test_queue.empty(); test_queue.pop_front())
-          {
-            auto& nd = test_queue.front();
-            switch(nd.query.parser)  // test the data
-            {
-              case Parser::Discard:
-                std::cout << "discarding" << std::endl;
-                break;
-
-              case Parser::Complete:
-                db.addStation(nd.station), ++insertion_count;
-                break;
-
-              case Parser::ReplaceRecord | Parser::MapArea:
-                db.addMapLocation(nd);
-                break;
-
-              case Parser::BuildQuery | Parser::MapArea:
-              {
-                bool lookup = false;
-                if(nd.query.bounds)
-                  lookup = bool(db.identifyMapLocation(nd));
-                else if(auto locdata = db.getMapLocation(*nd.station.network_id, *nd.query.node_id); locdata)
-                {
-                  nd = *locdata;
-                  lookup = true;
-                }
-
-                if(lookup)
-                {
-                  scraper.second->classify(nd); // scraper decides parser this should use
-                  if(nd.query.child_ids) // has children
-                  {
-                    for(auto& node_id : ext::to_list(*nd.query.child_ids))
-                    {
-                      pair_data_t tmp;
-                      tmp.query.parser = Parser::BuildQuery | Parser::MapArea;
-                      tmp.query.node_id = node_id;
-                      tmp.station.network_id = nd.station.network_id;
-                      test_queue.emplace_back(tmp); // queue to be tested
-                    }
-                  }
-                  else // no children
-                  {
-                    if(nd.query.parser == (Parser::BuildQuery | Parser::MapArea)) // parser didn't change
-                      main_queue.emplace_back(nd); // more data is needed, queue for querying
-                    else
-                      test_queue.emplace_back(nd); // queue to be tested
-                  }
-                }
-                else
-                {
-                  db.addMapLocation(nd);
-                  main_queue.emplace_back(nd);
-                }
-                break;
-              }
-
-              case Parser::BuildQuery | Parser::Station:
-                if(auto id = *nd.query.node_id; !station_nodes.contains(id))
-                {
-                  station_nodes.insert(id);
-                  main_queue.emplace_back(nd);
-                }
-                break;
-
-              case Parser::BuildQuery | Parser::Port:
-                if(auto id = *nd.query.node_id; !port_nodes.contains(id))
-                {
-                  port_nodes.insert(id);
-                  main_queue.emplace_back(nd);
-                }
-                break;
-
-              default:
-                main_queue.emplace_back(nd);
-            }
-          }
+        for(const auto& crawler : crawlers)
+        {
+          insertion_count = crawler.insertions();
+          std::cout << crawler.name() << " insertions made: " << insertion_count << std::endl;
+          if(crawler.skipped())
+            std::cout << crawler.name() << " still fresh, skipped: " << crawler.skipped() << std::endl;
+          if(crawler.redundant())
+            std::cout << crawler.name() << " map areas already covered, resolved from cache: " << crawler.redundant() << std::endl;
+          total_insertions += insertion_count;
         }
-        std::cout << scraper.first << " insertions made: " << insertion_count << std::endl;
+      };
 
-        total_insertions += insertion_count;
+      if(parallel) // each scraper gets its own crawl context, all sharing one database writer
+        run_crawlers(std::begin(scraper_list), std::end(scraper_list));
+      else
+        for(auto pos = std::begin(scraper_list); pos != std::end(scraper_list); ++pos)
+          run_crawlers(pos, std::next(pos));
 
+      for(auto& scraper : scraper_list)
+      {
         delete scraper.second;
         scraper.second = nullptr;
       }
       std::cout << "total insertions: " << total_insertions << std::endl;
+      if(cache)
+        std::cout << "response cache: "
+                  << cache->stats().stored << " stored, "
+                  << cache->stats().not_modified << " not modified, "
+                  << cache->stats().replayed << " replayed, "
+                  << cache->stats().missing << " missing" << std::endl;
     }
     catch(std::string& error) // parser or SQL failure
     {
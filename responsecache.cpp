@@ -0,0 +1,81 @@
+#include "responsecache.h"
+
+// STL
+#include <fstream>
+#include <iterator>
+#include <cstdio>
+
+// POSIX
+#include <sys/stat.h>
+
+static uint64_t fnv1a(std::string_view data, uint64_t hash = 0xcbf29ce484222325) noexcept
+{
+  for(unsigned char c : data)
+    hash = (hash ^ c) * 0x100000001b3;
+  return hash;
+}
+
+static std::string to_hex(uint64_t value)
+{
+  char buffer[17];
+  std::snprintf(buffer, sizeof(buffer), "%016llx", static_cast<unsigned long long>(value));
+  return buffer;
+}
+
+ResponseCache::ResponseCache(std::string_view directory, bool offline)
+  : m_directory(directory),
+    m_offline(offline)
+{
+  ::mkdir(m_directory.c_str(), 0755);
+}
+
+std::string ResponseCache::path(const query_info_t& query) const
+{
+  uint64_t hash = fnv1a(query.URL);
+  hash = fnv1a(std::string_view("\n", 1), hash);
+  return m_directory + "/" + to_hex(fnv1a(query.post_data, hash));
+}
+
+// file layout: URL, POST data hash, ETag, Last-Modified, each on their own line, then the body
+std::optional<cached_response_t> ResponseCache::load(const query_info_t& query) const
+{
+  std::ifstream file(path(query), std::ios::binary);
+  if(!file)
+    return {};
+
+  std::string url, post_hash;
+  cached_response_t response;
+  if(!std::getline(file, url) ||
+     !std::getline(file, post_hash) ||
+     !std::getline(file, response.etag) ||
+     !std::getline(file, response.last_modified))
+    return {};
+
+  if(url != query.URL || post_hash != to_hex(fnv1a(query.post_data))) // hash collision
+    return {};
+
+  response.body.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+  return response;
+}
+
+void ResponseCache::store(const query_info_t& query, const cached_response_t& response)
+{
+  std::string filename = path(query);
+  std::string partial = filename + ".partial";
+  std::ofstream file(partial, std::ios::binary | std::ios::trunc);
+  if(!file)
+    return;
+  file << query.URL << '\n'
+       << to_hex(fnv1a(query.post_data)) << '\n'
+       << response.etag << '\n'
+       << response.last_modified << '\n'
+       << response.body;
+  file.close();
+
+  if(!file || std::rename(partial.c_str(), filename.c_str())) // readers never see a partial entry
+  {
+    std::remove(partial.c_str());
+    return;
+  }
+  ++m_stats.stored;
+}
@@ -0,0 +1,47 @@
+#ifndef RESPONSECACHE_H
+#define RESPONSECACHE_H
+
+#include <string>
+#include <string_view>
+#include <optional>
+#include <atomic>
+
+#include <scrapers/scraper_types.h>
+
+struct cached_response_t
+{
+  std::string etag;
+  std::string last_modified;
+  std::string body;
+};
+
+// one file per request, named by a hash of the URL and POST data
+// safe to share between crawlers, every method works on its own file
+class ResponseCache
+{
+public:
+  struct stats_t
+  {
+    std::atomic<uint64_t> stored = 0;
+    std::atomic<uint64_t> not_modified = 0; // revalidated with a 304
+    std::atomic<uint64_t> replayed = 0;     // served offline
+    std::atomic<uint64_t> missing = 0;      // offline and never cached
+  };
+
+  ResponseCache(std::string_view directory, bool offline);
+
+  bool offline(void) const noexcept { return m_offline; } // replay only, never touch the network
+  stats_t& stats(void) noexcept { return m_stats; }
+
+  std::optional<cached_response_t> load(const query_info_t& query) const;
+  void store(const query_info_t& query, const cached_response_t& response);
+
+private:
+  std::string path(const query_info_t& query) const;
+
+  std::string m_directory;
+  bool m_offline;
+  stats_t m_stats;
+};
+
+#endif // RESPONSECACHE_H
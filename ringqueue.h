@@ -0,0 +1,95 @@
+#ifndef RINGQUEUE_H
+#define RINGQUEUE_H
+
+#include <memory>
+#include <utility>
+
+#include <cstddef>
+
+// single-threaded FIFO over one contiguous power-of-two buffer that doubles when full
+// elements are moved in and out, never copied, so a steady workload stops allocating
+template<typename T>
+class ring_queue
+{
+public:
+  ring_queue(std::size_t capacity = 16) { reserve(capacity); }
+  ring_queue(const ring_queue&) = delete;
+  ring_queue& operator =(const ring_queue&) = delete;
+
+  ~ring_queue(void)
+  {
+    clear();
+    m_allocator.deallocate(m_buffer, m_capacity);
+  }
+
+  template<typename... Args>
+  T& emplace_back(Args&&... args)
+  {
+    if(m_size == m_capacity)
+      reserve(m_capacity * 2);
+    T* slot = std::construct_at(m_buffer + ((m_head + m_size) & (m_capacity - 1)), std::forward<Args>(args)...);
+    ++m_size;
+    return *slot;
+  }
+
+  void push_back(T&& value) { emplace_back(std::move(value)); }
+
+  T& front(void) noexcept { return m_buffer[m_head]; }
+
+  void pop_front(void) noexcept
+  {
+    std::destroy_at(m_buffer + m_head);
+    m_head = (m_head + 1) & (m_capacity - 1);
+    --m_size;
+  }
+
+  // moves the oldest element out, references into the queue do not survive a later emplace_back
+  T take_front(void)
+  {
+    T value = std::move(front());
+    pop_front();
+    return value;
+  }
+
+  bool empty(void) const noexcept { return !m_size; }
+  std::size_t size(void) const noexcept { return m_size; }
+  std::size_t capacity(void) const noexcept { return m_capacity; }
+
+  void clear(void) noexcept
+  {
+    while(m_size)
+      pop_front();
+    m_head = 0;
+  }
+
+  void reserve(std::size_t capacity)
+  {
+    std::size_t size = 2;
+    while(size < capacity)
+      size <<= 1;
+    if(size <= m_capacity)
+      return;
+
+    T* buffer = m_allocator.allocate(size);
+    for(std::size_t i = 0; i < m_size; ++i)
+    {
+      T* old = m_buffer + ((m_head + i) & (m_capacity - 1));
+      std::construct_at(buffer + i, std::move(*old));
+      std::destroy_at(old);
+    }
+    if(m_buffer)
+      m_allocator.deallocate(m_buffer, m_capacity);
+    m_buffer = buffer;
+    m_capacity = size;
+    m_head = 0;
+  }
+
+private:
+  std::allocator<T> m_allocator;
+  T* m_buffer = nullptr;
+  std::size_t m_capacity = 0;
+  std::size_t m_head = 0;
+  std::size_t m_size = 0;
+};
+
+#endif // RINGQUEUE_H
@@ -7,13 +7,17 @@
 
 #include <iostream>
 #include <algorithm>
-#include <regex>
 
-#include <map>
 #include <set>
 
 #include <shortjson/shortjson.h>
 #include "utilities.h"
+#include "chargehub_matchers.h"
+
+// locationsmap answers at most this many stations, a tile that hits it is split into quadrants
+constexpr std::size_t result_limit = 5000;
+constexpr double minimum_tile_span = 0.001; // degrees, smaller tiles are accepted as truncated
+constexpr std::string_view tile_prefix = "tile"; // node ids of map tiles, quadrants append 0-3
 
 std::string to_lowercase(const std::string& input)
 {
@@ -25,7 +29,10 @@ std::string to_lowercase(const std::string& input)
 
 void ChargehubScraper::classify(pair_data_t& record) const
 {
-  record.query.parser = Parser::BuildQuery | Parser::Station;
+  if(record.query.node_id && record.query.node_id->starts_with(tile_prefix))
+    record.query.parser = Parser::BuildQuery | Parser::MapArea;
+  else
+    record.query.parser = Parser::BuildQuery | Parser::Station;
 }
 
 pair_data_t ChargehubScraper::BuildQuery(const pair_data_t& input) const
@@ -47,13 +54,16 @@ pair_data_t ChargehubScraper::BuildQuery(const pair_data_t& input) const
 
     case Parser::BuildQuery | Parser::MapArea:
       data.query.parser = Parser::MapArea;
-      data.query.URL= ext::string("https://apiv2.chargehub.com/api/locationsmap?latmin=%0&latmax=%1&lonmin=%2&lonmax=%3&limit=5000&key=olitest&remove_networks=&remove_levels=&remove_connectors=&remove_other=0&above_power=")
+      data.query.URL= ext::string("https://apiv2.chargehub.com/api/locationsmap?latmin=%0&latmax=%1&lonmin=%2&lonmax=%3&limit=%4&key=olitest&remove_networks=&remove_levels=&remove_connectors=&remove_other=0&above_power=")
                       .arg(input.query.bounds.latitude.min)
                       .arg(input.query.bounds.latitude.max)
                       .arg(input.query.bounds.longitude.min)
-                      .arg(input.query.bounds.longitude.max);
+                      .arg(input.query.bounds.longitude.max)
+                      .arg(std::to_string(result_limit));
       data.query.header_fields = { { "Content-Type", "application/json" }, };
       data.query.bounds = input.query.bounds;
+      data.query.node_id = input.query.node_id;
+      data.station.network_id = Network::ChargeHub;
       break;
 
     case Parser::BuildQuery | Parser::Station:
@@ -74,7 +84,7 @@ std::vector<pair_data_t> ChargehubScraper::Parse(const pair_data_t& data, const
     {
       default: throw std::string(__FILE__).append(": unknown parser: ").append(std::to_string(int(data.query.parser)));
       case Parser::Initial: return ParserInit(data);
-      case Parser::MapArea: return ParseMapArea(input);
+      case Parser::MapArea: return ParseMapArea(data, input);
       case Parser::Station: return ParseStation(data, input);
     }
   }
@@ -91,41 +101,97 @@ std::vector<pair_data_t> ChargehubScraper::Parse(const pair_data_t& data, const
   return std::vector<pair_data_t>();
 }
 
+// the whole area is one tile, the crawler looks it up in the map cache before fetching
 std::vector<pair_data_t> ChargehubScraper::ParserInit(const pair_data_t& data) const
 {
-  std::vector<pair_data_t> return_data;
   pair_data_t nd;
-
   nd.query.parser = Parser::BuildQuery | Parser::MapArea;
-  nd.query.bounds.longitude = data.query.bounds.longitude;
+  nd.query.node_id = tile_prefix;
+  nd.query.bounds = data.query.bounds;
   nd.station.network_id = Network::ChargeHub;
-
-  constexpr double latitude_step = 0.25;
-  for(double latitude = data.query.bounds.latitude.min;
-      latitude < data.query.bounds.latitude.max;
-      latitude += latitude_step)
-  {
-    nd.query.bounds.latitude = { latitude + latitude_step, latitude };
-    return_data.emplace_back(BuildQuery(nd));
-  }
-  return return_data;
+  return {{ nd }};
 }
 
-std::vector<pair_data_t> ChargehubScraper::ParseMapArea(const std::string &input) const
+std::vector<pair_data_t> ChargehubScraper::ParseMapArea(const pair_data_t& data, const std::string& input) const
 {
   std::vector<pair_data_t> return_data;
   safenode_t root = shortjson::Parse(input);
+  auto locations = root.safeArray();
+
+  pair_data_t tile = data;
+  tile.query.parser = Parser::ReplaceRecord | Parser::MapArea;
 
-  for(const safenode_t& nodeL0 : root.safeArray())
+  if(locations.size() >= result_limit) // truncated, split into quadrants
   {
-    pair_data_t nd;
-    nd.query.parser = Parser::BuildQuery | Parser::Station;
+    if(data.query.bounds.latitude.distance() > minimum_tile_span &&
+       data.query.bounds.longitude.distance() > minimum_tile_span)
+    {
+      const coords_t center = data.query.bounds.getFocus();
+      const std::array<map_bounds_t, 4> quadrants =
+      {
+        map_bounds_t{ { data.query.bounds.latitude.max, center.latitude }, { data.query.bounds.longitude.min, center.longitude } },
+        map_bounds_t{ { data.query.bounds.latitude.max, center.latitude }, { center.longitude, data.query.bounds.longitude.max } },
+        map_bounds_t{ { center.latitude, data.query.bounds.latitude.min }, { data.query.bounds.longitude.min, center.longitude } },
+        map_bounds_t{ { center.latitude, data.query.bounds.latitude.min }, { center.longitude, data.query.bounds.longitude.max } },
+      };
+
+      ext::string child_ids;
+      return_data.reserve(1 + quadrants.size());
+      return_data.emplace_back(); // the tile goes first
+      for(std::size_t quadrant = 0; quadrant < quadrants.size(); ++quadrant)
+      {
+        pair_data_t nd;
+        nd.query.parser = Parser::BuildQuery | Parser::MapArea;
+        nd.query.node_id = *data.query.node_id + char('0' + quadrant);
+        nd.query.bounds = quadrants[quadrant];
+        nd.station.network_id = Network::ChargeHub;
+        child_ids.list_append(',', *nd.query.node_id);
+        return_data.emplace_back(std::move(nd));
+      }
+      tile.query.child_ids = child_ids;
+      return_data.front() = std::move(tile);
+      return return_data;
+    }
+    std::cerr << "chargehub tile " << *data.query.node_id << " is still truncated at "
+              << data.query.bounds.latitude.distance() << "x" << data.query.bounds.longitude.distance() << " degrees" << std::endl;
+  }
+
+  // complete tile, its stations become its children in the map cache
+  // an empty child list still marks the tile as explored
+  // a truncated tile keeps no children so the next run asks for it again
+  ext::string child_ids;
+  return_data.reserve(1 + 2 * locations.size()); // a map record and a station query each
+  return_data.emplace_back(); // the tile goes first
+  for(const safenode_ref& nodeL0 : locations)
+  {
+    pair_data_t location;
+    std::optional<double> latitude, longitude;
+    location.query.parser = Parser::ReplaceRecord | Parser::MapArea;
+    location.station.network_id = Network::ChargeHub;
+
+    for(const safenode_ref& nodeL1 : nodeL0.safeObject())
+    {
+      nodeL1.idString("LocID", location.query.node_id) ||
+      nodeL1.idFloat("Lat", latitude) ||
+      nodeL1.idFloat("Long", longitude);
+    }
 
-    for(const safenode_t& nodeL1 : nodeL0.safeObject())
-      nodeL1.idString("LocID", nd.query.node_id);
+    if(!location.query.node_id)
+      continue;
 
-    return_data.emplace_back(nd);
+    if(latitude && longitude)
+      location.query.bounds = { { *latitude, *latitude }, { *longitude, *longitude } };
+    child_ids.list_append(',', *location.query.node_id);
+    pair_data_t nd;
+    nd.query.parser = Parser::BuildQuery | Parser::Station;
+    nd.query.node_id = location.query.node_id;
+    return_data.emplace_back(std::move(location));
+    return_data.emplace_back(std::move(nd));
   }
+  tile.query.covered = locations.size() < result_limit;
+  if(tile.query.covered)
+    tile.query.child_ids = child_ids;
+  return_data.front() = std::move(tile);
   return return_data;
 }
 
@@ -239,39 +305,25 @@ void price_processor(price_t& price)
   }
   else if(price.unit && price.per_unit && price.text)
   {
-    if(std::regex_match(*price.text, std::regex("^\\$([[:digit:]]*[.][[:digit:]][[:digit:]])[[:space:]]/[[:space:]](kWh|hr|min)", std::regex_constants::extended)))
+    std::string_view amount;
+    Unit unit;
+    if(match_unit_price(*price.text, amount, unit))
       price.text.reset();
   }
   else if(!price.unit && !price.per_unit && price.text)
   {
-    std::smatch match;
-    if(std::regex_match(*price.text, match, std::regex("^\\$([[:digit:]]*[.][[:digit:]][[:digit:]])[[:space:]]/[[:space:]](kWh|hr|min)", std::regex_constants::extended)))
+    std::string_view amount;
+    Unit unit;
+    if(match_unit_price(*price.text, amount, unit))
     {
-      enum
-      {
-        UnitPrice = 1,
-        UnitType,
-      };
-
-      price.per_unit = ext::from_string<double>(match[UnitPrice].str());
-      if(match[UnitType].str() == "hr")
-        price.unit = Unit::Hours;
-      else if(match[UnitType].str() == "kWh")
-        price.unit = Unit::KilowattHours;
-      else if(match[UnitType].str() == "min")
-        price.unit = Unit::Minutes;
+      price.per_unit = ext::from_string<double>(std::string(amount));
+      price.unit = unit;
       price.text.reset();
     }
   }
 }
 
 
-enum Language
-{
-  English = 0,
-  French,
-};
-
 enum DayValues
 {
   Monday = 0,
@@ -285,14 +337,6 @@ enum DayValues
   Ambiguous,
 };
 
-constexpr std::array<std::array<std::string_view, 7>, 2> day_name_data =
-{
-  {
-    { "monday", "tuesday",  "wednesday",  "thursday", "friday",   "saturday", "sunday",   },
-    { "lundi",  "mardi",    "mercredi",   "jeudi",    "vendredi", "samedi",   "dimanche", },
-  }
-};
-
 
 DayValues day_number(Language lang, const std::string& day)
 {
@@ -325,64 +369,15 @@ DayValues day_number(Language lang, const std::string& day)
 
 uint32_t time_to_minutes(const std::string& time)
 {
-  enum
+  std::string_view text = time, match;
+  if(scan_time(text, match) && text.empty())
   {
-    Hours = 1,
-    Minutes,
-  };
-  std::smatch match;
-  if(std::regex_search(time, match, std::regex("^([[:digit:]]{1,2}):([[:digit:]]{2})$", std::regex_constants::extended)))
-    return (ext::from_string<uint32_t>(match[Hours].str()) * 60) +
-        ext::from_string<uint32_t>(match[Minutes].str());
-
-  return 0;
-}
-
-std::string days(Language lang, std::size_t length = std::string::npos)
-{
-  std::string result;
-  for(auto& name : day_name_data[lang])
-  {
-    if(!result.empty())
-      result.push_back('|');
-    result.append(name.substr(0, length));
+    std::size_t colon = match.find(':');
+    return (ext::from_string<uint32_t>(std::string(match.substr(0, colon))) * 60) +
+        ext::from_string<uint32_t>(std::string(match.substr(colon + 1)));
   }
-  return "(" + result + ")";
-}
 
-enum class RegexId
-{
-  DayList = 0,
-  DayRange,
-};
-
-const std::regex& day_regex(RegexId type, Language lang, std::size_t length = std::string::npos)
-{
-  using regexset = const std::map<std::pair<Language, std::size_t>, std::regex>;
-  auto build = [](const std::string_view regexstr) -> regexset
-   {
-    return
-    {
-      { { English, std::string::npos }, std::regex(ext::string(regexstr).arg(days(English)), std::regex_constants::extended) },
-      { { French , std::string::npos }, std::regex(ext::string(regexstr).arg(days(French )), std::regex_constants::extended) },
-      { { English, 3 }, std::regex(ext::string(regexstr).arg(days(English, 3)), std::regex_constants::extended) },
-      { { French , 3 }, std::regex(ext::string(regexstr).arg(days(French , 3)), std::regex_constants::extended) },
-      { { English, 2 }, std::regex(ext::string(regexstr).arg(days(English, 2)), std::regex_constants::extended) },
-      { { French , 2 }, std::regex(ext::string(regexstr).arg(days(French , 2)), std::regex_constants::extended) },
-      { { English, 1 }, std::regex(ext::string(regexstr).arg(days(English, 1)), std::regex_constants::extended) },
-      { { French , 1 }, std::regex(ext::string(regexstr).arg(days(French , 1)), std::regex_constants::extended) },
-    };
-   };
-  static const std::map<RegexId, regexset> regexes =
-  {
-    {
-      { RegexId::DayList, build("^((%0:?[[:space:]])+)(closed|([[:digit:]]{1,2}:[[:digit:]]{2})[[:space:]]?[~-][[:space:]]?([[:digit:]]{1,2}:[[:digit:]]{2}))") },
-      { RegexId::DayRange, build("^%0[[:space:]]?-[[:space:]]?%0:?[[:space:]](closed|([[:digit:]]{1,2}:[[:digit:]]{2})[[:space:]]?[~-][[:space:]]?([[:digit:]]{1,2}:[[:digit:]]{2}))") },
-    }
-  };
-
-  //regexes.at(type).at(std::make_pair(lang, length)).
-  return regexes.at(type).at(std::make_pair(lang, length));
+  return 0;
 }
 
 std::string process_schedule(const std::optional<std::string>& input)
@@ -399,7 +394,7 @@ std::string process_schedule(const std::optional<std::string>& input)
     if(input->find(':') && (input->find('~') || input->find('-')))
     {
       std::string haystack = to_lowercase(*input);
-      std::smatch match;
+      hours_match_t match;
 
       while(!haystack.empty())
       {
@@ -407,39 +402,19 @@ std::string process_schedule(const std::optional<std::string>& input)
         std::set<DayValues> selected_days;
         std::string start_time, end_time;
 
-        if(std::regex_search(haystack, match, std::regex("^([[:digit:]]{1,2}:[[:digit:]]{2})[[:space:]]?[~-][[:space:]]?([[:digit:]]{1,2}:[[:digit:]]{2})$", std::regex_constants::extended)))
-        {
-          enum
-          {
-            StartTime = 1,
-            EndTime,
-          };
-
-          if(match[StartTime].matched)
-            start_time = match[StartTime].str();
-          if(match[EndTime].matched)
-            end_time = match[EndTime].str();
+        if(match_daily_hours(haystack, match))
           selected_days = { Monday, Tuesday, Wednesday, Thursday, Friday, Saturday, Sunday, };
-        }
-        else if((lang = English, std::regex_search(haystack, match, day_regex(RegexId::DayRange, lang))) ||
-           (lang = French,  std::regex_search(haystack, match, day_regex(RegexId::DayRange, lang))) ||
-           (lang = English, std::regex_search(haystack, match, day_regex(RegexId::DayRange, lang, 3))) ||
-           (lang = French,  std::regex_search(haystack, match, day_regex(RegexId::DayRange, lang, 3))) ||
-           (lang = English, std::regex_search(haystack, match, day_regex(RegexId::DayRange, lang, 2))) ||
-           (lang = French,  std::regex_search(haystack, match, day_regex(RegexId::DayRange, lang, 2))) ||
-           (lang = English, std::regex_search(haystack, match, day_regex(RegexId::DayRange, lang, 1))) ||
-           (lang = French,  std::regex_search(haystack, match, day_regex(RegexId::DayRange, lang, 1))))
+        else if((lang = English, match_day_range(haystack, lang, match)) ||
+                (lang = French,  match_day_range(haystack, lang, match)) ||
+                (lang = English, match_day_range(haystack, lang, match, 3)) ||
+                (lang = French,  match_day_range(haystack, lang, match, 3)) ||
+                (lang = English, match_day_range(haystack, lang, match, 2)) ||
+                (lang = French,  match_day_range(haystack, lang, match, 2)) ||
+                (lang = English, match_day_range(haystack, lang, match, 1)) ||
+                (lang = French,  match_day_range(haystack, lang, match, 1)))
         {
-          enum
-          {
-            StartDay = 1,
-            EndDay,
-            StartTime = 4,
-            EndTime,
-          };
-
-          const int end_day = day_number(lang, match[EndDay].str());
-          int pos = day_number(lang, match[StartDay].str());
+          const int end_day = day_number(lang, std::string(match.end_day));
+          int pos = day_number(lang, std::string(match.start_day));
           if(pos > end_day)
           {
             while(pos < 7)
@@ -453,41 +428,29 @@ std::string process_schedule(const std::optional<std::string>& input)
           if(selected_days.contains(Ambiguous) ||
              selected_days.contains(Error))
             throw __LINE__;
-
-          if(match[StartTime].matched)
-            start_time = match[StartTime].str();
-          if(match[EndTime].matched)
-            end_time = match[EndTime].str();
         }
-        else if((lang = English, std::regex_search(haystack, match, day_regex(RegexId::DayList, lang))) ||
-                (lang = French,  std::regex_search(haystack, match, day_regex(RegexId::DayList, lang))) ||
-                (lang = English, std::regex_search(haystack, match, day_regex(RegexId::DayList, lang, 3))) ||
-                (lang = French,  std::regex_search(haystack, match, day_regex(RegexId::DayList, lang, 3))) ||
-                (lang = English, std::regex_search(haystack, match, day_regex(RegexId::DayList, lang, 2))) ||
-                (lang = French,  std::regex_search(haystack, match, day_regex(RegexId::DayList, lang, 2))) ||
-                (lang = English, std::regex_search(haystack, match, day_regex(RegexId::DayList, lang, 1))) ||
-                (lang = French,  std::regex_search(haystack, match, day_regex(RegexId::DayList, lang, 1))))
+        else if((lang = English, match_day_list(haystack, lang, match)) ||
+                (lang = French,  match_day_list(haystack, lang, match)) ||
+                (lang = English, match_day_list(haystack, lang, match, 3)) ||
+                (lang = French,  match_day_list(haystack, lang, match, 3)) ||
+                (lang = English, match_day_list(haystack, lang, match, 2)) ||
+                (lang = French,  match_day_list(haystack, lang, match, 2)) ||
+                (lang = English, match_day_list(haystack, lang, match, 1)) ||
+                (lang = French,  match_day_list(haystack, lang, match, 1)))
         {
-          enum
-          {
-            DayList = 1,
-            StartTime = 5,
-            EndTime,
-          };
-
-          for(const auto& pos : ext::to_list(match[DayList].str(), ' '))
+          for(const auto& pos : ext::to_list(std::string(match.day_list), ' '))
             if(!pos.empty())
               selected_days.insert(day_number(lang, pos));
-
-          if(match[StartTime].matched)
-            start_time = match[StartTime].str();
-          if(match[EndTime].matched)
-            end_time = match[EndTime].str();
         }
 
+        if(match.start_time)
+          start_time = *match.start_time;
+        if(match.end_time)
+          end_time = *match.end_time;
+
         if(!selected_days.empty())
         {
-          haystack = match.suffix();
+          haystack.erase(0, match.length);
 
           int start_time_mins = time_to_minutes(start_time);
           int end_time_mins = time_to_minutes(end_time);
@@ -526,91 +489,116 @@ std::vector<pair_data_t> ChargehubScraper::ParseStation(const pair_data_t& data,
   std::vector<pair_data_t> return_data;
   std::optional<std::string> tmpstr;
   safenode_t root = shortjson::Parse(input);
+  auto stations = root.safeObject();
+  return_data.reserve(stations.size());
 
-  for(const safenode_t& nodeL0 : root.safeObject())
+  for(const safenode_ref& nodeL0 : stations)
   {
-    pair_data_t nd = data;
+    pair_data_t nd; // a complete record only carries its station, not the request
+    nd.station = data.station;
     nd.query.parser = Parser::Complete;
 
-    for(const safenode_t& nodeL1 : nodeL0.safeObject())
+    for(const safenode_ref& nodeL1 : nodeL0.safeObject())
     {
-      if(nodeL1.idString("LocName", nd.station.name) ||
-         nodeL1.idString("LocDesc", nd.station.description) ||
-         nodeL1.idInteger("StreetNo", nd.station.contact.street_number) ||
-         nodeL1.idString("Street", nd.station.contact.street_name) ||
-         nodeL1.idString("City", nd.station.contact.city) ||
-         nodeL1.idString("prov_state", nd.station.contact.state) ||
-         nodeL1.idString("Country", nd.station.contact.country) ||
-         nodeL1.idString("Zip", nd.station.contact.postal_code) ||
-         nodeL1.idFloat("Lat", nd.station.location.latitude) ||
-         nodeL1.idFloat("Long", nd.station.location.longitude) ||
-         nodeL1.idString("Phone", nd.station.contact.phone_number) ||
-         nodeL1.idString("Web", nd.station.contact.URL) ||
-         nodeL1.idString("PriceString", nd.station.price.text) ||
-         nodeL1.idEnum("NetworkId", nd.station.network_id))
-      {
-      }
-      else if(nodeL1.idString("Id", tmpstr))
-      {
-        nd.station.meta_station_ids.push_back(*tmpstr);
-        nd.station.meta_network_ids.push_back(Network::ChargeHub);
-      }
-      else if(nodeL1.idString("AccessTime", tmpstr))
-      {
-        nd.station.schedule = process_schedule(tmpstr);
-        if(is_private(tmpstr))
-          nd.station.access_public = false;
-      }
-      else if(nodeL1.idString("AccessType", tmpstr))
-        nd.station.access_public = get_access_public(tmpstr);
-      else if(nodeL1.idString("PaymentMethods", tmpstr))
-        nd.station.price.payment |= get_payment_methods(tmpstr);
-      else if(nodeL1.idArray("PlugsArray"))
+      switch(nodeL1.field())
       {
-        price_processor(nd.station.price);
-        for(auto& nodeL2 : nodeL1.safeArray())
-        {
-          port_t port;
-          port.price = nd.station.price;
+        case "LocName"_field:     nodeL1.asString(nd.station.name); break;
+        case "LocDesc"_field:     nodeL1.asString(nd.station.description); break;
+        case "StreetNo"_field:    nodeL1.asInteger(nd.station.contact.street_number); break;
+        case "Street"_field:      nodeL1.asString(nd.station.contact.street_name); break;
+        case "City"_field:        nodeL1.asString(nd.station.contact.city); break;
+        case "prov_state"_field:  nodeL1.asString(nd.station.contact.state); break;
+        case "Country"_field:     nodeL1.asString(nd.station.contact.country); break;
+        case "Zip"_field:         nodeL1.asString(nd.station.contact.postal_code); break;
+        case "Lat"_field:         nodeL1.asFloat(nd.station.location.latitude); break;
+        case "Long"_field:        nodeL1.asFloat(nd.station.location.longitude); break;
+        case "Phone"_field:       nodeL1.asString(nd.station.contact.phone_number); break;
+        case "Web"_field:         nodeL1.asString(nd.station.contact.URL); break;
+        case "PriceString"_field: nodeL1.asString(nd.station.price.text); break;
+        case "NetworkId"_field:   nodeL1.asEnum(nd.station.network_id); break;
+
+        case "Id"_field:
+          if(nodeL1.asString(tmpstr))
+          {
+            nd.station.meta_station_ids.push_back(*tmpstr);
+            nd.station.meta_network_ids.push_back(Network::ChargeHub);
+          }
+          break;
 
-          for(auto& nodeL3 : nodeL2.safeObject())
+        case "AccessTime"_field:
+          if(nodeL1.asString(tmpstr))
           {
-            if(nodeL3.idInteger("Level", port.power.level) ||
-               nodeL3.idFloatUnit("Amp", port.power.amp) ||
-               nodeL3.idFloatUnit("Kw", port.power.kw) ||
-               nodeL3.idFloatUnit("Volt", port.power.volt) ||
-               nodeL3.idFloat("ChargingRate", port.price.per_unit) ||
-               nodeL3.idEnum("ChargingRateUnit", port.price.unit) ||
-               nodeL3.idEnum("Status", port.status) ||
-               nodeL3.idString("PriceString", port.price.text))
-            {
-            }
-            else if(nodeL3.idString("PaymentMethods", tmpstr))
-              port.price.payment |= get_payment_methods(tmpstr);
-            else if(nodeL3.idArray("Ports"))
+            nd.station.schedule = process_schedule(tmpstr);
+            if(is_private(tmpstr))
+              nd.station.access_public = false;
+          }
+          break;
+
+        case "AccessType"_field:
+          if(nodeL1.asString(tmpstr))
+            nd.station.access_public = get_access_public(tmpstr);
+          break;
+
+        case "PaymentMethods"_field:
+          if(nodeL1.asString(tmpstr))
+            nd.station.price.payment |= get_payment_methods(tmpstr);
+          break;
+
+        case "PlugsArray"_field:
+        {
+          price_processor(nd.station.price);
+          for(const auto& nodeL2 : nodeL1.safeArray())
+          {
+            port_t port;
+            port.price = nd.station.price;
+
+            for(const auto& nodeL3 : nodeL2.safeObject())
             {
-              price_processor(port.price);
-              for(auto& nodeL4 : nodeL3.safeArray())
+              switch(nodeL3.field())
               {
-                port_t thisport = port;
-                for(const safenode_t& portsL2 : nodeL4.safeObject())
-                {
-                  if(portsL2.idString("portId", thisport.port_id) ||
-                     portsL2.idString("displayName", thisport.display_name))
+                case "Level"_field:            nodeL3.asInteger(port.power.level); break;
+                case "Amp"_field:              nodeL3.asFloatUnit(port.power.amp); break;
+                case "Kw"_field:               nodeL3.asFloatUnit(port.power.kw); break;
+                case "Volt"_field:             nodeL3.asFloatUnit(port.power.volt); break;
+                case "ChargingRate"_field:     nodeL3.asFloat(port.price.per_unit); break;
+                case "ChargingRateUnit"_field: nodeL3.asEnum(port.price.unit); break;
+                case "Status"_field:           nodeL3.asEnum(port.status); break;
+                case "PriceString"_field:      nodeL3.asString(port.price.text); break;
+
+                case "PaymentMethods"_field:
+                  if(nodeL3.asString(tmpstr))
+                    port.price.payment |= get_payment_methods(tmpstr);
+                  break;
+
+                case "Ports"_field:
+                  price_processor(port.price);
+                  for(const auto& nodeL4 : nodeL3.safeArray())
                   {
+                    port_t thisport = port;
+                    for(const safenode_ref& portsL2 : nodeL4.safeObject())
+                    {
+                      if(portsL2.idString("portId", thisport.port_id) ||
+                         portsL2.idString("displayName", thisport.display_name))
+                      {
+                      }
+                      else if(portsL2.idString("netPortId", tmpstr))
+                        thisport.port_id = tmpstr;
+                    }
+                    nd.station.ports.push_back(std::move(thisport));
                   }
-                  else if(portsL2.idString("netPortId", tmpstr))
-                    thisport.port_id = tmpstr;
-                }
-                nd.station.ports.push_back(thisport);
+                  break;
+
+                case "Name"_field:
+                  if(nodeL3.asString(tmpstr))
+                  {
+                    for(auto& thisport : nd.station.ports)
+                      thisport.power.connector = connector_from_string(tmpstr);
+                  }
+                  break;
               }
             }
-            else if(nodeL3.idString("Name", tmpstr))
-            {
-              for(auto& thisport : nd.station.ports)
-                thisport.power.connector = connector_from_string(tmpstr);
-            }
           }
+          break;
         }
       }
     }
@@ -618,7 +606,7 @@ std::vector<pair_data_t> ChargehubScraper::ParseStation(const pair_data_t& data,
     if(nd.station.description && nd.station.description->empty())
       nd.station.description.reset();
 
-    return_data.emplace_back(nd);
+    return_data.emplace_back(std::move(nd));
   }
   return return_data;
 }
@@ -7,12 +7,13 @@ class ChargehubScraper : public ScraperBase
 {
 public:
   void classify(pair_data_t& record) const;
+  using ScraperBase::BuildQuery; // builds a fresh record, nothing to reuse from an rvalue
   pair_data_t BuildQuery(const pair_data_t& input) const;
   std::vector<pair_data_t> Parse(const pair_data_t& data, const std::string& input) const;
 
 private:
   std::vector<pair_data_t> ParserInit(const pair_data_t& data) const;
-  std::vector<pair_data_t> ParseMapArea(const std::string& input) const;
+  std::vector<pair_data_t> ParseMapArea(const pair_data_t& data, const std::string& input) const;
   std::vector<pair_data_t> ParseStation(const pair_data_t& data, const std::string& input) const;
 };
 
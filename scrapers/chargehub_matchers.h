@@ -0,0 +1,202 @@
+#ifndef CHARGEHUB_MATCHERS_H
+#define CHARGEHUB_MATCHERS_H
+
+#include <string>
+#include <string_view>
+#include <optional>
+#include <array>
+
+#include "scraper_types.h"
+
+// hand-rolled matchers for the price and schedule grammars, each consumes its match from text only on success
+constexpr bool is_space(char c) noexcept // [[:space:]]
+  { return c == ' ' || (c >= '\t' && c <= '\r'); }
+
+constexpr bool is_digit(char c) noexcept // [[:digit:]]
+  { return c >= '0' && c <= '9'; }
+
+inline bool scan_space(std::string_view& text)
+{
+  if(text.empty() || !is_space(text.front()))
+    return false;
+  text.remove_prefix(1);
+  return true;
+}
+
+inline bool scan_any(std::string_view& text, std::string_view chars)
+{
+  if(text.empty() || chars.find(text.front()) == std::string_view::npos)
+    return false;
+  text.remove_prefix(1);
+  return true;
+}
+
+inline bool scan_literal(std::string_view& text, std::string_view literal)
+{
+  if(!text.starts_with(literal))
+    return false;
+  text.remove_prefix(literal.size());
+  return true;
+}
+
+// [[:digit:]]{1,2}:[[:digit:]]{2}
+inline bool scan_time(std::string_view& text, std::string_view& time)
+{
+  std::size_t hour_digits = text.size() > 1 && is_digit(text[0]) && is_digit(text[1]) ? 2 :
+                            text.size() > 0 && is_digit(text[0]) ? 1 : 0;
+  if(!hour_digits ||
+     text.size() < hour_digits + 3 ||
+     text[hour_digits] != ':' ||
+     !is_digit(text[hour_digits + 1]) ||
+     !is_digit(text[hour_digits + 2]))
+    return false;
+  time = text.substr(0, hour_digits + 3);
+  text.remove_prefix(time.size());
+  return true;
+}
+
+// ^\$([[:digit:]]*[.][[:digit:]][[:digit:]])[[:space:]]/[[:space:]](kWh|hr|min)$
+inline bool match_unit_price(std::string_view text, std::string_view& amount, Unit& unit)
+{
+  if(!scan_literal(text, "$"))
+    return false;
+  std::string_view start = text;
+  while(!text.empty() && is_digit(text.front()))
+    text.remove_prefix(1);
+  if(!scan_literal(text, ".") ||
+     text.size() < 2 || !is_digit(text[0]) || !is_digit(text[1]))
+    return false;
+  text.remove_prefix(2);
+  amount = start.substr(0, start.size() - text.size());
+
+  if(!scan_space(text) || !scan_literal(text, "/") || !scan_space(text))
+    return false;
+  if(text == "kWh")
+    unit = Unit::KilowattHours;
+  else if(text == "hr")
+    unit = Unit::Hours;
+  else if(text == "min")
+    unit = Unit::Minutes;
+  else
+    return false;
+  return true;
+}
+
+enum Language
+{
+  English = 0,
+  French,
+};
+
+constexpr std::array<std::array<std::string_view, 7>, 2> day_name_data =
+{
+  {
+    { "monday", "tuesday",  "wednesday",  "thursday", "friday",   "saturday", "sunday",   },
+    { "lundi",  "mardi",    "mercredi",   "jeudi",    "vendredi", "samedi",   "dimanche", },
+  }
+};
+
+// one day name, whole or cut to length
+inline bool scan_day(std::string_view& text, Language lang, std::size_t length, std::string_view& day)
+{
+  for(const std::string_view& name : day_name_data[lang])
+  {
+    if(text.starts_with(name.substr(0, length)))
+    {
+      day = text.substr(0, name.substr(0, length).size());
+      text.remove_prefix(day.size());
+      return true;
+    }
+  }
+  return false;
+}
+
+struct hours_match_t
+{
+  std::string_view start_day;
+  std::string_view end_day;
+  std::string_view day_list;
+  std::optional<std::string_view> start_time; // unset when closed
+  std::optional<std::string_view> end_time;
+  std::size_t length = 0; // the rest of the schedule follows
+};
+
+// ([[:digit:]]{1,2}:[[:digit:]]{2})[[:space:]]?[~-][[:space:]]?([[:digit:]]{1,2}:[[:digit:]]{2})
+inline bool scan_time_range(std::string_view& text, hours_match_t& match)
+{
+  std::string_view pos = text, start_time, end_time;
+  if(!scan_time(pos, start_time))
+    return false;
+  scan_space(pos);
+  if(!scan_any(pos, "~-"))
+    return false;
+  scan_space(pos);
+  if(!scan_time(pos, end_time))
+    return false;
+
+  match.start_time = start_time;
+  match.end_time = end_time;
+  text = pos;
+  return true;
+}
+
+// closed|time_range
+inline bool scan_hours(std::string_view& text, hours_match_t& match)
+  { return scan_literal(text, "closed") || scan_time_range(text, match); }
+
+// ^time_range$
+inline bool match_daily_hours(std::string_view text, hours_match_t& match)
+{
+  match = hours_match_t();
+  std::string_view pos = text;
+  if(!scan_time_range(pos, match) || !pos.empty())
+    return false;
+  match.length = text.size();
+  return true;
+}
+
+// ^day[[:space:]]?-[[:space:]]?day:?[[:space:]]hours
+inline bool match_day_range(std::string_view text, Language lang, hours_match_t& match, std::size_t length = std::string::npos)
+{
+  match = hours_match_t();
+  std::string_view pos = text;
+  if(!scan_day(pos, lang, length, match.start_day))
+    return false;
+  scan_space(pos);
+  if(!scan_literal(pos, "-"))
+    return false;
+  scan_space(pos);
+  if(!scan_day(pos, lang, length, match.end_day))
+    return false;
+  scan_literal(pos, ":");
+  if(!scan_space(pos) || !scan_hours(pos, match))
+    return false;
+  match.length = text.size() - pos.size();
+  return true;
+}
+
+// ^((day:?[[:space:]])+)hours
+inline bool match_day_list(std::string_view text, Language lang, hours_match_t& match, std::size_t length = std::string::npos)
+{
+  match = hours_match_t();
+  std::string_view pos = text, day;
+  for(;;)
+  {
+    std::string_view next = pos;
+    if(!scan_day(next, lang, length, day))
+      break;
+    scan_literal(next, ":");
+    if(!scan_space(next))
+      break;
+    pos = next;
+  }
+  if(pos.size() == text.size()) // no days
+    return false;
+  match.day_list = text.substr(0, text.size() - pos.size());
+  if(!scan_hours(pos, match))
+    return false;
+  match.length = text.size() - pos.size();
+  return true;
+}
+
+#endif // CHARGEHUB_MATCHERS_H
@@ -538,7 +538,7 @@ std::vector<pair_data_t> EchargeScraper::ParseMapArea(const std::string& input)
 std::vector<pair_data_t> EchargeScraper::ParseStation([[maybe_unused]] const pair_data_t& data, const std::string& input) const
 {
   std::map<std::string, pair_data_t> stations;
-  auto stationData = [&stations](const safenode_t& node, int line) -> pair_data_t&
+  auto stationData = [&stations](const safenode_ref& node, int line) -> pair_data_t&
   {
     if(node.type != shortjson::Field::Object)
       throw line;
@@ -587,7 +587,7 @@ std::vector<pair_data_t> EchargeScraper::ParseStation([[maybe_unused]] const pai
     {
       for(const auto& nodeL1 : nodeL0.safeObject())
       {
-        auto nd = stationData(nodeL1, __LINE__);
+        auto& nd = stationData(nodeL1, __LINE__);
         port_t port;
         for(const auto& nodeL2 : nodeL1.safeObject())
         {
@@ -606,9 +606,10 @@ std::vector<pair_data_t> EchargeScraper::ParseStation([[maybe_unused]] const pai
           }
           else if(nodeL2.idArray("Connectors"))
           {
-            if(nodeL2.safeArray().size() != 1)
+            auto entries = nodeL2.safeArray();
+            if(entries.size() != 1)
               throw __LINE__;
-            for(const auto& nodeL3 : nodeL2.safeArray().front().safeObject())
+            for(const auto& nodeL3 : entries.front().safeObject())
             {
               if(nodeL3.idString("Type", tmpstr))
               {
@@ -631,7 +632,7 @@ std::vector<pair_data_t> EchargeScraper::ParseStation([[maybe_unused]] const pai
             }
           }
         }
-        nd.station.ports.emplace_back(port);
+        nd.station.ports.emplace_back(std::move(port));
       }
     }
     else if(nodeL0.idObject("chargingStations"))
@@ -660,7 +661,7 @@ std::vector<pair_data_t> EchargeScraper::ParseStation([[maybe_unused]] const pai
           }
           else if(nodeL0.idObject("Address"))
           {
-            for(const safenode_t& nodeL1 : nodeL0.safeObject())
+            for(const safenode_ref& nodeL1 : nodeL0.safeObject())
             {
               if(nodeL1.idString("City", nd.station.contact.city) ||
                  nodeL1.idString("Country", nd.station.contact.country) ||
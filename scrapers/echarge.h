@@ -6,6 +6,7 @@
 class EchargeScraper : public ScraperBase
 {
 public:
+  using ScraperBase::BuildQuery; // builds a fresh record, nothing to reuse from an rvalue
   pair_data_t BuildQuery(const pair_data_t& input) const;
   std::vector<pair_data_t> Parse(const pair_data_t& data, const std::string& input) const;
 
@@ -10,26 +10,30 @@
 #include <shortjson/shortjson.h>
 
 // project
-#include <tinf/src/tinf.h>
 #include "utilities.h"
 
+// the locations list can arrive gzipped without a Content-Encoding header
 std::string decompress(const std::string& input)
 {
-  std::vector<uint8_t> buffer(0x000100000);
-  unsigned int size = std::size(buffer);
-  assert(tinf_gzip_uncompress(std::data(buffer), &size, std::data(input), std::size(input)) == 0);
-  return std::string(reinterpret_cast<const char*>(std::data(buffer)), size);
+  if(auto output = ext::gunzip(input); output)
+    return *output;
+  return input;
 }
 
 
 pair_data_t ElectrifyAmericaScraper::BuildQuery(const pair_data_t& input) const
 {
-  pair_data_t data = input;
+  return BuildQuery(pair_data_t(input));
+}
+
+pair_data_t ElectrifyAmericaScraper::BuildQuery(pair_data_t&& input) const
+{
+  pair_data_t data = std::move(input);
   data.station.network_id = Network::Electrify_America;
 
   switch(data.query.parser)
   {
-    default: throw std::string(__FILE__).append(": unknown parser: ").append(std::to_string(int(input.query.parser)));
+    default: throw std::string(__FILE__).append(": unknown parser: ").append(std::to_string(int(data.query.parser)));
 
     case Parser::BuildQuery | Parser::Initial:
     case Parser::BuildQuery | Parser::MapArea:
@@ -70,6 +74,35 @@ std::vector<pair_data_t> ElectrifyAmericaScraper::Parse(const pair_data_t& data,
   return {};
 }
 
+std::vector<pair_data_t> ElectrifyAmericaScraper::ParseElement(const pair_data_t& data, std::string_view element) const
+{
+  std::string input(element);
+  try
+  {
+    switch(data.query.parser)
+    {
+      default: throw std::string(__FILE__).append(": unknown parser: ").append(std::to_string(int(data.query.parser)));
+      case Parser::MapArea:
+      {
+        std::vector<pair_data_t> return_data;
+        ParseSite(shortjson::Parse(input), return_data);
+        return return_data;
+      }
+    }
+  }
+  catch(int line_number)
+  {
+    std::cerr << __FILE__ << " threw from line: " << line_number << std::endl;
+    std::cerr << "element dump:" << std::endl << input << std::endl;
+  }
+  catch(const char* msg)
+  {
+    std::cerr << "JSON parser threw: " << msg << std::endl;
+    std::cerr << "element dump:" << std::endl << input << std::endl;
+  }
+  return {};
+}
+
 std::vector<pair_data_t> ElectrifyAmericaScraper::ParseMapArea([[maybe_unused]] const pair_data_t& data, const std::string& input) const
 {
   auto input_str = decompress(input);
@@ -79,24 +112,29 @@ std::vector<pair_data_t> ElectrifyAmericaScraper::ParseMapArea([[maybe_unused]]
   if(root.type != shortjson::Field::Array)
     throw __LINE__;
 
-  for(const safenode_t& nodeL0 : root.safeArray())
-  {
-    if(nodeL0.type != shortjson::Field::Object)
-      throw __LINE__;
-
-    ext::string siteId;
-    if(shortjson::FindString(nodeL0, siteId, "siteId"))
-    {
-      pair_data_t nd;
-      nd.query.parser = Parser::BuildQuery | Parser::Station;
-      nd.query.node_id = siteId;
-      return_data.emplace_back(nd);
-    }
-  }
+  auto sites = root.safeArray();
+  return_data.reserve(sites.size());
+  for(const safenode_ref& nodeL0 : sites)
+    ParseSite(nodeL0, return_data);
 
   return return_data;
 }
 
+void ElectrifyAmericaScraper::ParseSite(const safenode_ref& node, std::vector<pair_data_t>& return_data) const
+{
+  if(node.type != shortjson::Field::Object)
+    throw __LINE__;
+
+  ext::string siteId;
+  if(shortjson::FindString(node, siteId, "siteId"))
+  {
+    pair_data_t nd;
+    nd.query.parser = Parser::BuildQuery | Parser::Station;
+    nd.query.node_id = siteId;
+    return_data.emplace_back(std::move(nd));
+  }
+}
+
 std::vector<pair_data_t> ElectrifyAmericaScraper::ParseStation(const pair_data_t& data, const std::string& input) const
 {
   safenode_t root = shortjson::Parse(input);
@@ -113,7 +151,7 @@ std::vector<pair_data_t> ElectrifyAmericaScraper::ParseStation(const pair_data_t
   std::optional<std::string> tmpstr;
   std::optional<bool> tmpbool;
 
-  for(const safenode_t& nodeL0 : root.safeObject())
+  for(const safenode_ref& nodeL0 : root.safeObject())
   {
     if(nodeL0.idString("siteId", nd.station.station_id) ||
        nodeL0.idString("name", nd.station.name) ||
@@ -148,11 +186,11 @@ std::vector<pair_data_t> ElectrifyAmericaScraper::ParseStation(const pair_data_t
     }
     else if(nodeL0.idObject("openingTimes"))
     {
-      for(const safenode_t& nodeL1 : nodeL0.safeObject())
+      for(const safenode_ref& nodeL1 : nodeL0.safeObject())
       {
         if(nodeL1.idArray("regularHours"))
         {
-          for([[maybe_unused]] const safenode_t& nodeL2 : nodeL1.safeArray())
+          for([[maybe_unused]] const safenode_ref& nodeL2 : nodeL1.safeArray())
           {
             throw __LINE__; // never seen
           }
@@ -161,13 +199,13 @@ std::vector<pair_data_t> ElectrifyAmericaScraper::ParseStation(const pair_data_t
     }
     else if(nodeL0.idArray("pricing"))
     {
-      for(const safenode_t& nodeL1 : nodeL0.safeArray())
+      for(const safenode_ref& nodeL1 : nodeL0.safeArray())
       {
         if(nodeL1.type != shortjson::Field::Object)
           throw __LINE__;
         price_t price;
         price.currency = Currency::USD;
-        for(const safenode_t& nodeL2 : nodeL1.safeObject())
+        for(const safenode_ref& nodeL2 : nodeL1.safeObject())
         {
           if(nodeL2.idFloat("time", price.per_unit))
             price.unit = Unit::Minutes;
@@ -190,23 +228,23 @@ std::vector<pair_data_t> ElectrifyAmericaScraper::ParseStation(const pair_data_t
     }
     else if(nodeL0.idArray("evses"))
     {
-      for(const safenode_t& nodeL1 : nodeL0.safeArray())
+      for(const safenode_ref& nodeL1 : nodeL0.safeArray())
       {
         if(nodeL1.type != shortjson::Field::Object)
           throw __LINE__;
         port_t port;
-        for(const safenode_t& nodeL2 : nodeL1.safeObject())
+        for(const safenode_ref& nodeL2 : nodeL1.safeObject())
         {
           if(nodeL2.idString("id", port.port_id))
           {
           }
           else if(nodeL2.idArray("connectors"))
           {
-            for(const safenode_t& nodeL3 : nodeL2.safeArray())
+            for(const safenode_ref& nodeL3 : nodeL2.safeArray())
             {
               if(nodeL3.type != shortjson::Field::Object)
                 throw __LINE__;
-              for(const safenode_t& nodeL4 : nodeL3.safeObject())
+              for(const safenode_ref& nodeL4 : nodeL3.safeObject())
               {
                 if(nodeL4.idFloat("voltage", port.power.volt) ||
                    nodeL4.idFloat("amperage", port.power.amp))
@@ -246,10 +284,12 @@ std::vector<pair_data_t> ElectrifyAmericaScraper::ParseStation(const pair_data_t
             }
           }
         }
-        nd.station.ports.emplace_back(port);
+        nd.station.ports.emplace_back(std::move(port));
       }
     }
   }
 
-  return {{ nd }};
+  std::vector<pair_data_t> return_data;
+  return_data.emplace_back(std::move(nd)); // an initializer list would copy
+  return return_data;
 }
@@ -2,6 +2,7 @@
 #define ELECTRIFYAMERICA_H
 
 #include "scraper_base.h"
+#include "utilities.h"
 
 class ElectrifyAmericaScraper : public ScraperBase
 {
@@ -9,9 +10,14 @@ public:
   void classify([[maybe_unused]] pair_data_t& record) const {}
   std::vector<pair_data_t> Parse(const pair_data_t& data, const std::string& input) const;
   pair_data_t BuildQuery(const pair_data_t& data) const;
+  pair_data_t BuildQuery(pair_data_t&& data) const;
+
+  bool StreamsElements(const pair_data_t& data) const { return data.query.parser == Parser::MapArea; }
+  std::vector<pair_data_t> ParseElement(const pair_data_t& data, std::string_view element) const;
 
 private:
   std::vector<pair_data_t> ParseMapArea(const pair_data_t& data, const std::string& input) const;
+  void ParseSite(const safenode_ref& node, std::vector<pair_data_t>& return_data) const;
   std::vector<pair_data_t> ParseStation(const pair_data_t& data, const std::string& input) const;
 };
 
@@ -17,7 +17,12 @@ void EptixScraper::classify(pair_data_t& record) const
 
 pair_data_t EptixScraper::BuildQuery(const pair_data_t& input) const
 {
-  pair_data_t data = input;
+  return BuildQuery(pair_data_t(input));
+}
+
+pair_data_t EptixScraper::BuildQuery(pair_data_t&& input) const
+{
+  pair_data_t data = std::move(input);
 
   data.query.header_fields =
   {
@@ -30,7 +35,7 @@ pair_data_t EptixScraper::BuildQuery(const pair_data_t& input) const
 
   switch(data.query.parser)
   {
-    default: throw std::string(__FILE__).append(": unknown parser: ").append(std::to_string(int(input.query.parser)));
+    default: throw std::string(__FILE__).append(": unknown parser: ").append(std::to_string(int(data.query.parser)));
 
     case Parser::BuildQuery | Parser::Initial:
       data.query.parser = Parser::MapArea;
@@ -76,7 +81,8 @@ std::vector<pair_data_t> EptixScraper::Parse(const pair_data_t& data, const std:
     if(root.type == shortjson::Field::Array)
     {
       ext::string child_ids;
-      for(const safenode_t& nodeL0 : root.safeArray())
+      bool covered = true;
+      for(const safenode_ref& nodeL0 : root.safeArray())
         return_data.emplace_back(ParseStationNode(data, nodeL0));
       for(auto& child : return_data)
       {
@@ -84,15 +90,17 @@ std::vector<pair_data_t> EptixScraper::Parse(const pair_data_t& data, const std:
         if(child.query.parser == (Parser::BuildQuery | Parser::MapArea) ||
            child.query.parser == (Parser::BuildQuery | Parser::Station))
           child_ids.list_append(',', *child.query.node_id);
+        if(child.query.parser == (Parser::BuildQuery | Parser::MapArea)) // a cluster still needs zooming into
+          covered = false;
       }
 
-      pair_data_t parent;
-      parent = data;
+      pair_data_t parent = data;
       parent.query.parser = Parser::ReplaceRecord | Parser::MapArea;
+      parent.query.covered = covered;
       if(!child_ids.empty())
         parent.query.child_ids = child_ids;
       if(*data.query.node_id != "root")
-        return_data.emplace(std::begin(return_data), parent);
+        return_data.emplace(std::begin(return_data), std::move(parent));
     }
     else if(root.type == shortjson::Field::Object)
       return_data.emplace_back(ParseStationNode(data, root));
@@ -123,7 +131,7 @@ void optional_append(std::optional<std::string>& target, std::optional<std::stri
   }
 }
 
-std::optional<int32_t> get_level(const safenode_t& node)
+std::optional<int32_t> get_level(const safenode_ref& node)
 {
   if(node.type == shortjson::Field::String)
   {
@@ -142,7 +150,7 @@ std::optional<int32_t> get_level(const safenode_t& node)
   return {};
 }
 
-pair_data_t EptixScraper::ParseStationNode(const pair_data_t& data, const safenode_t& root) const
+pair_data_t EptixScraper::ParseStationNode(const pair_data_t& data, const safenode_ref& root) const
 {
   if(root.type != shortjson::Field::Object)
     throw __LINE__;
@@ -158,7 +166,7 @@ pair_data_t EptixScraper::ParseStationNode(const pair_data_t& data, const safeno
   std::optional<bool> tmpbool;
   std::optional<double> tmpdbl;
 
-  for(const safenode_t& nodeL0 : root.safeObject())
+  for(const safenode_ref& nodeL0 : root.safeObject())
   {
     if(nodeL0.type == shortjson::Field::Null)
       continue; // ignore field
@@ -204,11 +212,11 @@ pair_data_t EptixScraper::ParseStationNode(const pair_data_t& data, const safeno
     else if(nodeL0.idObject("stats"))
     {
       std::optional<int32_t> last365, last30;
-      for(const safenode_t& nodeL1 : nodeL0.safeObject())
+      for(const safenode_ref& nodeL1 : nodeL0.safeObject())
       {
         if(nodeL1.idObject("numberOfSessions"))
         {
-          for(const safenode_t& nodeL2 : nodeL1.safeObject())
+          for(const safenode_ref& nodeL2 : nodeL1.safeObject())
           {
             if(nodeL2.idInteger("lastTwelveMonths", last365) ||
                nodeL2.idInteger("lastMonth", last30))
@@ -239,7 +247,7 @@ pair_data_t EptixScraper::ParseStationNode(const pair_data_t& data, const safeno
     }
     else if(nodeL0.idObject("message"))
     {
-      for(const safenode_t& nodeL1 : nodeL0.safeObject())
+      for(const safenode_ref& nodeL1 : nodeL0.safeObject())
       {
         if(nodeL1.idString("text", tmpstr))
           optional_append(nd.station.description, tmpstr);
@@ -247,7 +255,8 @@ pair_data_t EptixScraper::ParseStationNode(const pair_data_t& data, const safeno
         {
           std::stringstream ss;
           std::time_t time = *tmpdbl;
-          ss << std::put_time(std::localtime(&time), "%Y-%m-%d %X");
+          std::tm local;
+          ss << std::put_time(localtime_r(&time, &local), "%Y-%m-%d %X");
           optional_append(nd.station.description, ss.str());
         }
         else
@@ -262,7 +271,7 @@ pair_data_t EptixScraper::ParseStationNode(const pair_data_t& data, const safeno
     }
     else if(nodeL0.idObject("network"))
     {
-      for(const safenode_t& nodeL1 : nodeL0.safeObject())
+      for(const safenode_ref& nodeL1 : nodeL0.safeObject())
       {
         if(nodeL1.idString("name", tmpstr))
         {
@@ -291,7 +300,7 @@ pair_data_t EptixScraper::ParseStationNode(const pair_data_t& data, const safeno
     }
     else if(nodeL0.idObject("address"))
     {
-      for(const safenode_t& nodeL1 : nodeL0.safeObject())
+      for(const safenode_ref& nodeL1 : nodeL0.safeObject())
       {
         if(nodeL1.idString("city", nd.station.contact.city) ||
            nodeL1.idString("country", nd.station.contact.country) ||
@@ -316,13 +325,13 @@ pair_data_t EptixScraper::ParseStationNode(const pair_data_t& data, const safeno
     }
     else if(nodeL0.idArray("stations"))
     {
-      for(const safenode_t& nodeL1 : nodeL0.safeArray())
+      for(const safenode_ref& nodeL1 : nodeL0.safeArray())
       {
         port_t port;
         port.status = status;
         if(nodeL1.type != shortjson::Field::Object)
           throw __LINE__;
-        for(const safenode_t& nodeL2 : nodeL1.safeObject())
+        for(const safenode_ref& nodeL2 : nodeL1.safeObject())
         {
           if(nodeL2.idString("id", port.port_id) ||
              nodeL2.idString("name", port.display_name) ||
@@ -333,12 +342,12 @@ pair_data_t EptixScraper::ParseStationNode(const pair_data_t& data, const safeno
             port.power.level = get_level(nodeL2);
           else if(nodeL2.idObject("tariff"))
           {
-            for(const safenode_t& nodeL3 : nodeL2.safeObject())
+            for(const safenode_ref& nodeL3 : nodeL2.safeObject())
             {
               if(nodeL3.identifier == "desc" &&
                  nodeL3.type == shortjson::Field::Object)
               {
-                for(const safenode_t& nodeL4 : nodeL3.safeObject())
+                for(const safenode_ref& nodeL4 : nodeL3.safeObject())
                   nodeL4.idString("en", port.price.text);
               }
               else if(nodeL3.idString("desc", port.price.text) ||
@@ -360,7 +369,7 @@ pair_data_t EptixScraper::ParseStationNode(const pair_data_t& data, const safeno
             }
           }
         }
-        nd.station.ports.emplace_back(port);
+        nd.station.ports.emplace_back(std::move(port));
       }
     }
   }
@@ -9,10 +9,11 @@ class EptixScraper : public ScraperBase
 public:
   void classify(pair_data_t& record) const;
   pair_data_t BuildQuery(const pair_data_t& input) const;
+  pair_data_t BuildQuery(pair_data_t&& input) const;
   std::vector<pair_data_t> Parse(const pair_data_t& data, const std::string& input) const;
 
 private:
-  pair_data_t ParseStationNode(const pair_data_t& data, const safenode_t& root) const;
+  pair_data_t ParseStationNode(const pair_data_t& data, const safenode_ref& root) const;
 };
 
 
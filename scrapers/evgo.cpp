@@ -41,7 +41,12 @@ void EVGoScraper::classify(pair_data_t& record) const
 
 pair_data_t EVGoScraper::BuildQuery(const pair_data_t& input) const
 {
-  pair_data_t data = input;
+  return BuildQuery(pair_data_t(input));
+}
+
+pair_data_t EVGoScraper::BuildQuery(pair_data_t&& input) const
+{
+  pair_data_t data = std::move(input);
   data.station.network_id = Network::EVgo;
 
   if(!data.query.node_id)
@@ -49,7 +54,7 @@ pair_data_t EVGoScraper::BuildQuery(const pair_data_t& input) const
 
   switch(data.query.parser)
   {
-    default: throw std::string(__FILE__).append(": unknown parser: ").append(std::to_string(int(input.query.parser)));
+    default: throw std::string(__FILE__).append(": unknown parser: ").append(std::to_string(int(data.query.parser)));
 
     case Parser::BuildQuery | Parser::Initial:
 #if 1
@@ -64,7 +69,7 @@ pair_data_t EVGoScraper::BuildQuery(const pair_data_t& input) const
       data.query.parser = Parser::BuildQuery | Parser::Port;
       data.query.node_id = 465;
 #endif
-      return BuildQuery(data);
+      return BuildQuery(std::move(data));
 
     case Parser::BuildQuery | Parser::MapArea:
     {
@@ -83,10 +88,10 @@ pair_data_t EVGoScraper::BuildQuery(const pair_data_t& input) const
                 "southWestLng": %3
               }
             })")
-          .arg(input.query.bounds.northEast().latitude)
-          .arg(input.query.bounds.northEast().longitude)
-          .arg(input.query.bounds.southWest().latitude)
-          .arg(input.query.bounds.southWest().longitude);
+          .arg(data.query.bounds.northEast().latitude)
+          .arg(data.query.bounds.northEast().longitude)
+          .arg(data.query.bounds.southWest().latitude)
+          .arg(data.query.bounds.southWest().longitude);
       post_data.erase({'\n',' '});
       data.query.post_data = post_data;
       data.query.header_fields = { { "Content-Type", "application/json" } };
@@ -191,9 +196,12 @@ std::vector<pair_data_t> EVGoScraper::ParseMapArea(const pair_data_t& data, cons
   std::vector<pair_data_t> return_data;
   ext::string child_ids;
   std::optional<std::string> tmpstr;
+  bool covered = true;
   auto response = response_parse(input);
+  auto areas = response.safeArray();
+  return_data.reserve(areas.size() + 1); // the parent is inserted in front without reallocating
 
-  for(const safenode_t& nodeL0 : response.safeArray())
+  for(const safenode_ref& nodeL0 : areas)
   {
     std::optional<uint64_t> quantity;
     std::optional<double> latitude, longitude;
@@ -202,7 +210,7 @@ std::vector<pair_data_t> EVGoScraper::ParseMapArea(const pair_data_t& data, cons
     if(nodeL0.type != shortjson::Field::Object)
       throw __LINE__;
 
-    for(const safenode_t& nodeL1 : nodeL0.safeObject())
+    for(const safenode_ref& nodeL1 : nodeL0.safeObject())
     {
       if(nodeL1.idString("@class", tmpstr))
       {
@@ -235,19 +243,22 @@ std::vector<pair_data_t> EVGoScraper::ParseMapArea(const pair_data_t& data, cons
       nd.query.bounds.setFocus({ *latitude, *longitude }); // move box to new location
       nd.query.bounds.zoom(1); // shrink box to new size
       nd.query.parser = Parser::BuildQuery | (quantity ? Parser::MapArea : Parser::Station);
-      return_data.emplace_back(nd);
+      if(quantity) // a cluster still needs zooming into
+        covered = false;
+      return_data.emplace_back(std::move(nd));
     }
     else
       throw __LINE__;
   }
 
-  if(!child_ids.empty())
+  if(!child_ids.empty() || covered)
   {
     pair_data_t nd = data;
     nd.query.parser = Parser::ReplaceRecord | Parser::MapArea;
+    nd.query.covered = covered;
     if(!child_ids.empty())
       nd.query.child_ids = child_ids;
-    return_data.emplace(std::begin(return_data), nd); // insert to front
+    return_data.emplace(std::begin(return_data), std::move(nd)); // insert to front
   }
 
   return return_data;
@@ -259,13 +270,15 @@ std::vector<pair_data_t> EVGoScraper::ParseStation([[maybe_unused]] const pair_d
   std::vector<pair_data_t> return_data;
   std::optional<std::string> tmpstr;
   auto response = response_parse(input);
+  auto stations = response.safeArray();
+  return_data.reserve(stations.size());
 
-  for(const safenode_t& nodeL0 : response.safeArray())
+  for(const safenode_ref& nodeL0 : stations)
   {
     if(nodeL0.type != shortjson::Field::Object)
       throw __LINE__;
 
-    for(const safenode_t& nodeL1 : nodeL0.safeObject())
+    for(const safenode_ref& nodeL1 : nodeL0.safeObject())
     {
       if(nodeL1.idString("@class", tmpstr))
       {
@@ -277,7 +290,7 @@ std::vector<pair_data_t> EVGoScraper::ParseStation([[maybe_unused]] const pair_d
         pair_data_t nd;
         nd.query.parser = Parser::BuildQuery | Parser::Port;
         nd.query.node_id = tmpstr;
-        return_data.emplace_back(nd);
+        return_data.emplace_back(std::move(nd));
       }
     }
   }
@@ -296,27 +309,29 @@ std::vector<pair_data_t> EVGoScraper::ParsePort(const pair_data_t& data, const s
   std::optional<std::string> port_name, tmpstr;
   std::optional<bool> tmpbool;
   bool credit_card_ok = false;
-  for(const safenode_t& nodeL0 : response.safeObject())
+  for(const safenode_ref& nodeL0 : response.safeObject())
   {
-    if(nodeL0.idString("siteId", nd.station.station_id) ||
-       nodeL0.idString("addressCity", nd.station.contact.city) ||
-       nodeL0.idString("addressCountryIso3Code", nd.station.contact.country) ||
-       nodeL0.idString("addressZipCode", nd.station.contact.postal_code) ||
-       nodeL0.idString("addressUsaStateCode", nd.station.contact.state) ||
-       nodeL0.idStreet("addressAddress1", nd.station.contact.street_number, nd.station.contact.street_name) ||
-       nodeL0.idFloat("latitude", nd.station.location.latitude) ||
-       nodeL0.idFloat("longitude", nd.station.location.longitude) ||
-       nodeL0.idString("caption", port_name) ||
-       nodeL0.idString("siteDisplayName", nd.station.name) ||
-       nodeL0.idString("notesForDriver", nd.station.description))
-    {
-    }
-    else if(nodeL0.idString("@class", tmpstr))
+    switch(nodeL0.field())
     {
-      if(tmpstr != "com.driivz.stationserver.bl.dto.imp.StationDtoImp")
-        throw __LINE__;
+      case "siteId"_field:                 nodeL0.asString(nd.station.station_id); continue;
+      case "addressCity"_field:            nodeL0.asString(nd.station.contact.city); continue;
+      case "addressCountryIso3Code"_field: nodeL0.asString(nd.station.contact.country); continue;
+      case "addressZipCode"_field:         nodeL0.asString(nd.station.contact.postal_code); continue;
+      case "addressUsaStateCode"_field:    nodeL0.asString(nd.station.contact.state); continue;
+      case "addressAddress1"_field:        nodeL0.asStreet(nd.station.contact.street_number, nd.station.contact.street_name); continue;
+      case "latitude"_field:               nodeL0.asFloat(nd.station.location.latitude); continue;
+      case "longitude"_field:              nodeL0.asFloat(nd.station.location.longitude); continue;
+      case "caption"_field:                nodeL0.asString(port_name); continue;
+      case "siteDisplayName"_field:        nodeL0.asString(nd.station.name); continue;
+      case "notesForDriver"_field:         nodeL0.asString(nd.station.description); continue;
+
+      case "@class"_field:
+        if(nodeL0.asString(tmpstr) && tmpstr != "com.driivz.stationserver.bl.dto.imp.StationDtoImp")
+          throw __LINE__;
+        continue;
     }
-    else if(nodeL0.idString("stationModelName", tmpstr))
+
+    if(nodeL0.idString("stationModelName", tmpstr))
     {
       std::transform(std::begin(*tmpstr), std::end(*tmpstr), std::begin(*tmpstr),
                      [](unsigned char c){ return c == 'K' ? 'k' : c; });
@@ -352,12 +367,12 @@ std::vector<pair_data_t> EVGoScraper::ParsePort(const pair_data_t& data, const s
     }
     else if(nodeL0.idArray("stationSockets"))
     {
-      for(const safenode_t& nodeL1 : nodeL0.safeArray())
+      for(const safenode_ref& nodeL1 : nodeL0.safeArray())
       {
         port_t port;
         if(credit_card_ok)
           port.price.payment |= Payment::Credit;
-        for(const safenode_t& nodeL2 : nodeL1.safeObject())
+        for(const safenode_ref& nodeL2 : nodeL1.safeObject())
         {
           if(nodeL2.idString("id", port.port_id) ||
              nodeL2.idFloat("stationModelSocketMaximumPower", port.power.kw))
@@ -394,9 +409,10 @@ std::vector<pair_data_t> EVGoScraper::ParsePort(const pair_data_t& data, const s
           }
           else if(nodeL2.idArray("socketPrices"))
           {
-            if(nodeL2.safeArray().size() != 1)
+            auto entries = nodeL2.safeArray();
+            if(entries.size() != 1)
               throw __LINE__;
-            for(const safenode_t& nodeL3 : nodeL2.safeArray().front().safeObject())
+            for(const safenode_ref& nodeL3 : entries.front().safeObject())
             {
               if(nodeL3.idFloat("transactionFee", port.price.initial))
               {
@@ -415,16 +431,16 @@ std::vector<pair_data_t> EVGoScraper::ParsePort(const pair_data_t& data, const s
             }
           }
         }
-        nd.station.ports.emplace_back(port);
+        nd.station.ports.emplace_back(std::move(port));
       }
     }
     else if(nodeL0.idArray("openingTimes"))
     {
       std::optional<int32_t> hour;
-      for(const safenode_t& nodeL1 : nodeL0.safeArray())
+      for(const safenode_ref& nodeL1 : nodeL0.safeArray())
       {
         int day_of_week = -1;
-        for(const safenode_t& nodeL2 : nodeL1.safeObject())
+        for(const safenode_ref& nodeL2 : nodeL1.safeObject())
         {
           if(nodeL2.idString("dayOfWeekId", tmpstr))
           {
@@ -457,5 +473,7 @@ std::vector<pair_data_t> EVGoScraper::ParsePort(const pair_data_t& data, const s
     port.display_name = port_name;
 
   nd.query.parser = Parser::Complete;
-  return {{ nd }};
+  std::vector<pair_data_t> return_data;
+  return_data.emplace_back(std::move(nd)); // an initializer list would copy
+  return return_data;
 }
@@ -8,6 +8,7 @@ class EVGoScraper : public ScraperBase
 public:
   void classify(pair_data_t& record) const;
   pair_data_t BuildQuery(const pair_data_t& data) const;
+  pair_data_t BuildQuery(pair_data_t&& data) const;
   std::vector<pair_data_t> Parse(const pair_data_t& data, const std::string& input) const;
 
 private:
@@ -3,6 +3,7 @@
 
 #include <unordered_set>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "scraper_types.h"
@@ -18,7 +19,14 @@ public:
 
   virtual void classify(pair_data_t& record) const = 0;
   virtual pair_data_t BuildQuery(const pair_data_t& input) const = 0;
+  // for records the caller is done with, scrapers that start from a copy of the input override it to reuse the input instead
+  virtual pair_data_t BuildQuery(pair_data_t&& input) const { return BuildQuery(static_cast<const pair_data_t&>(input)); }
   virtual std::vector<pair_data_t> Parse(const pair_data_t& data, const std::string& input) const = 0;
+
+  // pages that are a top-level JSON array may instead be parsed one element at a time while downloading
+  virtual bool StreamsElements([[maybe_unused]] const pair_data_t& data) const { return false; }
+  virtual std::vector<pair_data_t> ParseElement([[maybe_unused]] const pair_data_t& data,
+                                                [[maybe_unused]] std::string_view element) const { return {}; }
 };
 
 #endif // SCRAPER_BASE_H
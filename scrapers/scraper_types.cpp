@@ -318,13 +318,11 @@ bool schedule_t::incorporate(const schedule_t& o) noexcept
 
 // === station_t ===
 template<typename T>
-void incorporate_list(std::list<T>&a, const std::list<T>& b)
+void incorporate_list(std::vector<T>&a, const std::vector<T>& b)
 {
-  a.insert(std::end(a),
-               std::make_move_iterator(std::begin(b)),
-               std::make_move_iterator(std::end(b)));
+  a.insert(std::end(a), std::begin(b), std::end(b));
 
-  a.sort();
+  std::sort(std::begin(a), std::end(a));
   a.erase(std::unique(std::begin(a), std::end(a)), std::end(a));
 }
 
@@ -378,6 +376,31 @@ bool port_t::incorporate(const port_t& o) noexcept
       incorporate_optional(display_name, o.display_name);
 }
 
+// === pair_data_t ===
+#if defined(COUNT_COPIES)
+static thread_local uint64_t record_copies = 0;
+
+pair_data_t::pair_data_t(const pair_data_t& other)
+  : query(other.query), station(other.station)
+{
+  ++record_copies;
+}
+
+pair_data_t& pair_data_t::operator =(const pair_data_t& other)
+{
+  query = other.query;
+  station = other.station;
+  ++record_copies;
+  return *this;
+}
+
+uint64_t record_copy_count(void) noexcept
+  { return record_copies; }
+#else
+uint64_t record_copy_count(void) noexcept
+  { return 0; }
+#endif
+
 std::ostream& operator << (std::ostream &out, const Network value) noexcept
 {
   switch(value)
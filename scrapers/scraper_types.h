@@ -5,7 +5,6 @@
 #include <optional>
 #include <string>
 #include <vector>
-#include <list>
 #include <array>
 
 #include <cstdint>
@@ -228,11 +227,12 @@ struct query_info_t
   Parser parser;
   std::string URL;
   std::string post_data;
-  std::list<std::pair<std::string, std::string>> header_fields;
+  std::vector<std::pair<std::string, std::string>> header_fields;
   // map fields
   map_bounds_t bounds;
   std::optional<std::string> node_id;
   std::optional<std::string> child_ids;
+  bool covered = false; // every station inside bounds is among the results, nothing left to zoom into
 };
 
 struct power_t
@@ -248,16 +248,17 @@ struct power_t
   bool incorporate(const power_t& o) noexcept;
 };
 
+// members are ordered largest first so the one-byte fields share padding
 struct price_t
 {
   price_t(void) : payment(Payment::Undefined) { }
   std::optional<std::string>  text;
-  Payment                     payment;
-  std::optional<Currency>     currency;
   std::optional<double>       minimum;
   std::optional<double>       initial;
-  std::optional<Unit>         unit;
   std::optional<double>       per_unit;
+  Payment                     payment;
+  std::optional<Currency>     currency;
+  std::optional<Unit>         unit;
 
   operator bool(void) const noexcept;
   bool operator ==(const price_t& o) const noexcept;
@@ -299,16 +300,17 @@ struct schedule_t
 
 struct port_t
 {
-  std::optional<Network>  network_id;
   std::optional<std::string> station_id;
   std::optional<std::string> port_id;
 
-  std::optional<Status> status;
   power_t power;
   contact_t contact;
   price_t price;
   std::optional<std::string> display_name;
 
+  std::optional<Network>  network_id;
+  std::optional<Status> status;
+
   bool operator ==(const port_t& o) const noexcept { return port_id == o.port_id; }
   bool operator <(const port_t& o) const noexcept { return port_id < o.port_id; }
   bool incorporate(const port_t& o) noexcept;
@@ -317,8 +319,8 @@ struct port_t
 struct station_t
 {
   station_t(void) : location({0.0, 0.0}) {}
-  std::list<Network>          meta_network_ids;
-  std::list<std::string>      meta_station_ids;
+  std::vector<Network>        meta_network_ids;
+  std::vector<std::string>    meta_station_ids;
   std::optional<Network>      network_id;
   std::optional<std::string>  station_id;
 
@@ -335,7 +337,7 @@ struct station_t
   price_t price;
   schedule_t schedule;
 
-  std::list<port_t> ports;
+  std::vector<port_t> ports; // contiguous, merges scan them linearly
 
   bool incorporate(const station_t& o) noexcept;
 };
@@ -345,8 +347,19 @@ struct pair_data_t
 {
   query_info_t query;
   station_t station;
+
+#if defined(COUNT_COPIES)
+  pair_data_t(void) = default;
+  pair_data_t(pair_data_t&&) = default;
+  pair_data_t& operator =(pair_data_t&&) = default;
+  pair_data_t(const pair_data_t& other);
+  pair_data_t& operator =(const pair_data_t& other);
+#endif
 };
 
+// records copied by the current thread, only counted when built with COUNT_COPIES, otherwise always zero
+uint64_t record_copy_count(void) noexcept;
+
 
 
 template<typename T>
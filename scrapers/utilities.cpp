@@ -5,6 +5,10 @@
 
 // C
 #include <cctype>
+#include <climits>
+
+// libraries
+#include <tinf/src/tinf.h>
 
 namespace ext
 {
@@ -262,7 +266,7 @@ namespace ext
 
 
   // ext::to_string functions
-  std::string to_string(const std::list<std::string>& s_list, const char deliminator)
+  std::string to_string(const std::vector<std::string>& s_list, const char deliminator)
   {
     string combined;
     for(auto& e : s_list)
@@ -271,18 +275,89 @@ namespace ext
   }
 
   // ext::to_list functions
-  std::list<std::string> to_list(const std::string& str, const char deliminator)
+  std::vector<std::string> to_list(const std::string& str, const char deliminator)
   {
-    std::list<std::string> s_list;
+    std::vector<std::string> s_list;
     for(auto& s : ext::string(str).split_string({ deliminator }))
       s_list.emplace_back(s);
     return s_list;
   }
 
-  std::list<std::string> to_list(const std::optional<std::string>& str, const char deliminator)
+  std::vector<std::string> to_list(const std::optional<std::string>& str, const char deliminator)
   {
     if(!str)
       return {};
     return to_list(*str, deliminator);
   }
+
+  // content decoding
+
+  // no response body is trusted to decode beyond this, whatever it claims
+  constexpr std::size_t max_decoded_size = std::size_t(256) << 20;
+  static_assert(max_decoded_size <= UINT_MAX, "tinf sizes are unsigned int");
+
+  // grows the output buffer until decoder(output, size) fits, size is the capacity in and the length out
+  // gives up once max_decoded_size is not enough either
+  template<typename Decoder>
+  static std::optional<std::string> decode_growing(std::string_view data, Decoder decoder)
+  {
+    for(std::size_t capacity = std::clamp<std::size_t>(std::size(data) * 4, 0x1000, max_decoded_size);;
+        capacity = std::min(capacity * 2, max_decoded_size))
+    {
+      std::string output(capacity, '\0');
+      unsigned int size = capacity;
+      int result = decoder(output, size);
+      if(result == TINF_OK)
+      {
+        output.resize(size);
+        return output;
+      }
+      if(result != TINF_BUF_ERROR || capacity == max_decoded_size)
+        break;
+    }
+    return {};
+  }
+
+  std::optional<std::string> gunzip(std::string_view data)
+  {
+    if(!is_gzip(data))
+      return {};
+
+    // the trailer holds the uncompressed size modulo 2^32 and comes from the server,
+    // so it only sizes the buffer while plausible for the compressed length
+    const uint8_t* trailer = reinterpret_cast<const uint8_t*>(std::data(data) + std::size(data) - 4);
+    unsigned int size = trailer[0] | (trailer[1] << 8) | (trailer[2] << 16) | (unsigned(trailer[3]) << 24);
+
+    if(size <= std::size(data) * 32 && size <= max_decoded_size)
+    {
+      std::string output(size, '\0');
+      int result = tinf_gzip_uncompress(std::data(output), &size, std::data(data), std::size(data));
+      if(result == TINF_OK)
+      {
+        output.resize(size);
+        return output;
+      }
+      if(result != TINF_BUF_ERROR)
+        return {};
+    }
+
+    return decode_growing(data, [data](std::string& output, unsigned int& size)
+      { return tinf_gzip_uncompress(std::data(output), &size, std::data(data), std::size(data)); });
+  }
+
+  std::optional<std::string> inflate(std::string_view data)
+  {
+    // no size is recorded
+    return decode_growing(data, [data](std::string& output, unsigned int& size)
+    {
+      unsigned int capacity = size;
+      int result = tinf_zlib_uncompress(std::data(output), &size, std::data(data), std::size(data));
+      if(result == TINF_DATA_ERROR) // servers often send raw deflate despite the name
+      {
+        size = capacity;
+        result = tinf_uncompress(std::data(output), &size, std::data(data), std::size(data));
+      }
+      return result;
+    });
+  }
 }
@@ -10,9 +10,11 @@
 
 // C++
 #include <string>
+#include <string_view>
 #include <type_traits>
 #include <algorithm>
 #include <functional>
+#include <iterator>
 
 // C
 #include <cassert>
@@ -181,252 +183,341 @@ namespace ext
 
   // ext::to_string functions
 
-  std::string to_string(const std::list<std::string>& s_list, const char deliminator = ',');
+  std::string to_string(const std::vector<std::string>& s_list, const char deliminator = ',');
 
   template<typename T>
-  std::string to_string(const std::list<T>& t_list, const std::function<std::string(const T&)>& accessor, const char deliminator = ',')
+  std::string to_string(const std::vector<T>& t_list, const std::function<std::string(const T&)>& accessor, const char deliminator = ',')
   {
-    std::list<std::string> s_list;
+    std::vector<std::string> s_list;
+    s_list.reserve(t_list.size());
     for(auto& e : t_list)
       s_list.emplace_back(accessor(e));
     return to_string(s_list, deliminator);
   }
 
   template<typename T, std::enable_if_t<std::is_arithmetic_v<T>, bool> = true>
-  std::string to_string(const std::list<T>& t_list, const char deliminator = ',')
+  std::string to_string(const std::vector<T>& t_list, const char deliminator = ',')
     { return to_string<T>(t_list, [](const T t) { return std::to_string(t); }, deliminator); }
 
   template<typename T, std::enable_if_t<std::is_scoped_enum_v<T>, bool> = true>
-  std::string to_string(const std::list<T>& t_list, const char deliminator = ',')
+  std::string to_string(const std::vector<T>& t_list, const char deliminator = ',')
     { return to_string<T>(t_list, [](const T& e) { return std::to_string(static_cast<typename std::underlying_type_t<const T>>(e)); }, deliminator); }
 
   template<typename T>
   std::string to_string(const std::initializer_list<T>& i_list, const char deliminator = ',')
-    { return to_string<T>(std::list<T>(i_list), deliminator); }
+    { return to_string<T>(std::vector<T>(i_list), deliminator); }
 
   // ext::to_string functions
-  std::list<std::string> to_list(const std::string& str, const char deliminator = ',');
+  std::vector<std::string> to_list(const std::string& str, const char deliminator = ',');
 
   template<typename T>//, std::enable_if_t<(!std::is_arithmetic_v<T> && !std::is_scoped_enum_v<T>), bool> = true>
-  std::list<T> to_list(const std::string& str, const std::function<T(const std::string&)>& placer, const char deliminator = ',')
+  std::vector<T> to_list(const std::string& str, const std::function<T(const std::string&)>& placer, const char deliminator = ',')
   {
-    std::list<T> t_list;
+    std::vector<T> t_list;
     for(auto& e : ext::string(str).split_string({ deliminator }))
       t_list.emplace_back(placer(e));
     return t_list;
   }
 
   template<typename T, std::enable_if_t<std::is_arithmetic_v<T>, bool> = true>
-  std::list<T> to_list(const std::string& str, const char deliminator = ',')
+  std::vector<T> to_list(const std::string& str, const char deliminator = ',')
     { return to_list<T>(str, [](const std::string& s) { return ext::from_string<T>(s); }, deliminator); }
 
   template<typename T, std::enable_if_t<std::is_scoped_enum_v<T>, bool> = true>
-  std::list<T> to_list(const std::string& str, const char deliminator = ',')
+  std::vector<T> to_list(const std::string& str, const char deliminator = ',')
     { return to_list<T>(str, [](const std::string& s) { return T(ext::from_string<typename std::underlying_type_t<T>>(s)); }, deliminator); }
 
-  std::list<std::string> to_list(const std::optional<std::string>& str, const char deliminator = ',');
+  std::vector<std::string> to_list(const std::optional<std::string>& str, const char deliminator = ',');
 
   template<typename T>
-  std::list<T> to_list(const std::optional<std::string>& str, const char deliminator = ',')
+  std::vector<T> to_list(const std::optional<std::string>& str, const char deliminator = ',')
   {
     if(!str)
       return {};
     return to_list<T>(*str, deliminator);
   }
+
+  // content decoding, whole buffers only since tinf can't inflate incrementally
+  constexpr bool is_gzip(std::string_view data) noexcept
+    { return data.size() >= 18 && uint8_t(data[0]) == 0x1f && uint8_t(data[1]) == 0x8b; }
+
+  std::optional<std::string> gunzip(std::string_view data); // nothing if data isn't valid gzip
+  std::optional<std::string> inflate(std::string_view data); // zlib wrapped or raw deflate
+
+  // FNV-1a of a JSON member name, usable as a case label
+  constexpr uint64_t field_hash(std::string_view name) noexcept
+  {
+    uint64_t hash = 0xcbf29ce484222325;
+    for(char c : name)
+      hash = (hash ^ uint8_t(c)) * 0x100000001b3;
+    return hash;
+  }
 }
 
+// switch(node.field()) { case "Name"_field: ... }
+constexpr uint64_t operator ""_field(const char* name, std::size_t length) noexcept
+  { return ext::field_hash(std::string_view(name, length)); }
+
 // shortJSON helper wrapper struct functions
-struct safenode_t : shortjson::node_t
+struct safenode_ref;
+
+// the children of an object or array node, walked in place without copying them
+class safenode_view_t
 {
-  using shortjson::node_t::node_t;
-  safenode_t(const shortjson::node_t& other) : shortjson::node_t(other) { }
+public:
+  class iterator
+  {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = safenode_ref;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+    using reference = safenode_ref; // a wrapper made on the fly, the tree holds plain node_t
 
+    iterator(const shortjson::node_t* pos = nullptr) noexcept : m_pos(pos) { }
+
+    reference operator *(void) const noexcept;
+    iterator& operator ++(void) noexcept { ++m_pos; return *this; }
+    iterator operator ++(int) noexcept { iterator prev = *this; ++m_pos; return prev; }
+    bool operator ==(const iterator& other) const noexcept { return m_pos == other.m_pos; }
+    bool operator !=(const iterator& other) const noexcept { return m_pos != other.m_pos; }
+
+  private:
+    const shortjson::node_t* m_pos;
+  };
+
+  safenode_view_t(void) noexcept = default; // no children (null node)
+  safenode_view_t(const std::vector<shortjson::node_t>& children) noexcept
+    : m_begin(children.data()), m_end(children.data() + children.size()) { }
+
+  iterator begin(void) const noexcept { return m_begin; }
+  iterator end(void) const noexcept { return m_end; }
+  std::size_t size(void) const noexcept { return std::size_t(m_end - m_begin); }
+  bool empty(void) const noexcept { return m_begin == m_end; }
+  safenode_ref front(void) const noexcept;
+
+private:
+  const shortjson::node_t* m_begin = nullptr;
+  const shortjson::node_t* m_end = nullptr;
+};
+
+// the accessors over a node of a parsed tree, which it doesn't own
+struct safenode_ref
+{
+  safenode_ref(const shortjson::node_t& node) noexcept
+    : identifier(node.identifier), type(node.type), m_node(node) { }
+
+  const std::string& identifier;
+  const shortjson::Field& type;
+
+  const std::string& toString(void) const { return m_node.toString(); }
+  int64_t toNumber(void) const { return m_node.toNumber(); }
+  double toFloat(void) const { return m_node.toFloat(); }
+  bool toBool(void) const { return m_node.toBool(); }
+  operator const shortjson::node_t&(void) const noexcept { return m_node; } // for the shortjson functions
+
+  // key to switch on, compare against "name"_field
+  uint64_t field(void) const noexcept { return ext::field_hash(identifier); }
+
+  // as* read the value of a node already matched by its key
   template<int line_number>
-  bool idString(const std::string_view& identifier, std::optional<std::string>& value) const
+  bool asString(std::optional<std::string>& value) const
   {
-    if(this->identifier == identifier)
-    {
+    value.reset();
+    if(type == shortjson::Field::String)
+      value = toString();
+    else if(type == shortjson::Field::Integer)
+      value = std::to_string(toNumber());
+    else if(type == shortjson::Field::Float)
+      value = std::to_string(toFloat());
+    else if(type == shortjson::Field::Null)
       value.reset();
-      if(type == shortjson::Field::String)
-        value = toString();
-      else if(type == shortjson::Field::Integer)
-        value = std::to_string(toNumber());
-      else if(type == shortjson::Field::Float)
-        value = std::to_string(toFloat());
-      else if(type == shortjson::Field::Null)
-        value.reset();
-      else
-        throw line_number;
-      return bool(value);
-    }
-    return false;
+    else
+      throw line_number;
+    return bool(value);
   }
 
   template<int line_number>
-  bool idBool(const std::string_view& identifier, std::optional<bool>& value) const
+  bool asBool(std::optional<bool>& value) const
   {
-    if(this->identifier == identifier)
-    {
+    value.reset();
+    if(type == shortjson::Field::Boolean)
+      value = toBool();
+    else if(type == shortjson::Field::Integer && (toNumber() == 1 || toNumber() == 0))
+      value = bool(toNumber());
+    else if(type == shortjson::Field::String && toString() == "true")
+      value = true;
+    else if(type == shortjson::Field::String && toString() == "false")
+      value = false;
+    else if(type == shortjson::Field::Null ||
+            (type == shortjson::Field::String && toString() == "null"))
       value.reset();
-      if(type == shortjson::Field::Boolean)
-        value = toBool();
-      else if(type == shortjson::Field::Integer && (toNumber() == 1 || toNumber() == 0))
-        value = bool(toNumber());
-      else if(type == shortjson::Field::String && toString() == "true")
-        value = true;
-      else if(type == shortjson::Field::String && toString() == "false")
-        value = false;
-      else if(type == shortjson::Field::Null ||
-              (type == shortjson::Field::String && toString() == "null"))
-        value.reset();
-      else
-        throw line_number;
-      return bool(value);
-    }
-    return false;
+    else
+      throw line_number;
+    return bool(value);
   }
 
   template<int line_number, typename integer_t, std::enable_if_t<std::is_integral_v<integer_t>, bool> = true>
-  bool idInteger(const std::string_view& identifier, std::optional<integer_t>& value) const
+  bool asInteger(std::optional<integer_t>& value) const
   {
-    if(this->identifier == identifier)
+    value.reset();
+    if(type == shortjson::Field::Boolean)
+      value = toBool() ? 1 : 0;
+    else if(type == shortjson::Field::Integer)
+      value = toNumber();
+    else if(type == shortjson::Field::String)
     {
-      value.reset();
-      if(type == shortjson::Field::Boolean)
-        value = toBool() ? 1 : 0;
-      else if(type == shortjson::Field::Integer)
-        value = toNumber();
-      else if(type == shortjson::Field::String)
+      try
       {
-        try
-        {
-          value = ext::from_string<integer_t>(toString(), nullptr, 0);
-          if(std::to_string(*value) != toString())
-            value.reset();
-        }
-        catch(...) { value.reset(); }
+        value = ext::from_string<integer_t>(toString(), nullptr, 0);
+        if(std::to_string(*value) != toString())
+          value.reset();
       }
-      else if(type == shortjson::Field::Null)
-        value.reset();
-      else
-        throw line_number;
-      return bool(value);
+      catch(...) { value.reset(); }
     }
-    return false;
+    else if(type == shortjson::Field::Null)
+      value.reset();
+    else
+      throw line_number;
+    return bool(value);
+  }
+
+  template<int line_number, typename integer_t>
+  bool asInteger(integer_t& value) const
+  {
+    std::optional<integer_t> v;
+    if(asInteger<line_number, integer_t>(v))
+      value = v.value();
+    return bool(v);
   }
 
   template<int line_number, typename floating_t>
-  bool idFloat(const std::string_view& identifier, std::optional<floating_t>& value) const
+  bool asFloat(std::optional<floating_t>& value) const
   {
-    if(this->identifier == identifier)
+    value.reset();
+    if(type == shortjson::Field::Float)
+      value = toFloat();
+    else if(type == shortjson::Field::Integer)
+      value = toNumber();
+    else if(type == shortjson::Field::String)
     {
-      value.reset();
-      if(type == shortjson::Field::Float)
-        value = toFloat();
-      else if(type == shortjson::Field::Integer)
-        value = toNumber();
-      else if(type == shortjson::Field::String)
+      try
       {
-        try
-        {
-          value = ext::from_string<floating_t>(toString(), nullptr);
-          if(std::to_string(*value) != toString())
-            value.reset();
-        }
-        catch(...) { value.reset(); }
+        value = ext::from_string<floating_t>(toString(), nullptr);
+        if(std::to_string(*value) != toString())
+          value.reset();
       }
-      else if(type == shortjson::Field::Null)
-        value.reset();
-      else
-        throw line_number;
-      return bool(value);
+      catch(...) { value.reset(); }
     }
-    return false;
+    else if(type == shortjson::Field::Null)
+      value.reset();
+    else
+      throw line_number;
+    return bool(value);
   }
 
   template<int line_number, typename floating_t>
-  bool idFloat(const std::string_view& identifier, floating_t& value) const
+  bool asFloat(floating_t& value) const
   {
     std::optional<floating_t> v;
-    if(idFloat<line_number, floating_t>(identifier, v))
+    if(asFloat<line_number, floating_t>(v))
       value = v.value();
     return bool(v);
   }
 
-
   template<int line_number, typename floating_t>
-  bool idFloatUnit(const std::string_view& identifier, std::optional<floating_t>& value) const
+  bool asFloatUnit(std::optional<floating_t>& value) const
   {
-    if(this->identifier == identifier)
+    value.reset();
+    if(type == shortjson::Field::String)
     {
-      value.reset();
-      if(type == shortjson::Field::String)
+      try
       {
-        try
-        {
-          std::size_t pos = 0;
-          value = ext::from_string<floating_t>(toString(), &pos);
-          if(!pos)
-            value.reset();
-        }
-        catch(...) { value.reset(); }
+        std::size_t pos = 0;
+        value = ext::from_string<floating_t>(toString(), &pos);
+        if(!pos)
+          value.reset();
       }
-      else if(type == shortjson::Field::Null)
-        value.reset();
-      else
-        throw line_number;
-      return bool(value);
+      catch(...) { value.reset(); }
     }
-    return false;
+    else if(type == shortjson::Field::Null)
+      value.reset();
+    else
+      throw line_number;
+    return bool(value);
   }
 
   template<int line_number, typename enum_t, std::enable_if_t<std::is_enum_v<enum_t>, bool> = true>
-  bool idEnum(const std::string_view& identifier, std::optional<enum_t>& value) const
+  bool asEnum(std::optional<enum_t>& value) const
   {
-    using underint_t = typename std::underlying_type_t<enum_t>;
-    std::optional<underint_t> v;
-    if(idInteger<line_number, std::underlying_type_t<enum_t>>(identifier, v))
+    std::optional<std::underlying_type_t<enum_t>> v;
+    if(asInteger<line_number, std::underlying_type_t<enum_t>>(v))
       value = enum_t(v.value());
     return bool(v);
   }
 
-  template<int line_number, typename integer_t>
-  bool idInteger(const std::string_view& identifier, integer_t& value) const
+  template<int line_number>
+  bool asStreet(std::optional<uint32_t>& street_number,
+                std::optional<std::string>& street_name) const
   {
-    std::optional<integer_t> v;
-    if(idInteger<line_number, integer_t>(identifier, v))
-      value = v.value();
-    return bool(v);
+    street_number.reset();
+    street_name.reset();
+    if(type != shortjson::Field::String)
+      throw line_number;
+    auto val = toString();
+    try
+    {
+      auto pos = std::find_if(std::begin(val), std::end(val),
+                     [](unsigned char c){ return std::isspace(c); });
+      street_number = ext::from_string<int32_t>(std::string(std::begin(val), pos));
+      pos = std::next(pos);
+      street_name = std::string(pos, std::end(val));
+    }
+    catch(...)
+    {
+      street_name = val;
+    }
+    return bool(street_name);
   }
 
+  // id* match the identifier first
+  template<int line_number>
+  bool idString(const std::string_view& identifier, std::optional<std::string>& value) const
+    { return this->identifier == identifier && asString<line_number>(value); }
+
+  template<int line_number>
+  bool idBool(const std::string_view& identifier, std::optional<bool>& value) const
+    { return this->identifier == identifier && asBool<line_number>(value); }
+
+  template<int line_number, typename integer_t, std::enable_if_t<std::is_integral_v<integer_t>, bool> = true>
+  bool idInteger(const std::string_view& identifier, std::optional<integer_t>& value) const
+    { return this->identifier == identifier && asInteger<line_number, integer_t>(value); }
+
+  template<int line_number, typename floating_t>
+  bool idFloat(const std::string_view& identifier, std::optional<floating_t>& value) const
+    { return this->identifier == identifier && asFloat<line_number, floating_t>(value); }
+
+  template<int line_number, typename floating_t>
+  bool idFloat(const std::string_view& identifier, floating_t& value) const
+    { return this->identifier == identifier && asFloat<line_number, floating_t>(value); }
+
+  template<int line_number, typename floating_t>
+  bool idFloatUnit(const std::string_view& identifier, std::optional<floating_t>& value) const
+    { return this->identifier == identifier && asFloatUnit<line_number, floating_t>(value); }
+
+  template<int line_number, typename enum_t, std::enable_if_t<std::is_enum_v<enum_t>, bool> = true>
+  bool idEnum(const std::string_view& identifier, std::optional<enum_t>& value) const
+    { return this->identifier == identifier && asEnum<line_number, enum_t>(value); }
+
+  template<int line_number, typename integer_t>
+  bool idInteger(const std::string_view& identifier, integer_t& value) const
+    { return this->identifier == identifier && asInteger<line_number, integer_t>(value); }
+
   template<int line_number>
   bool idStreet(const std::string_view& identifier,
                      std::optional<uint32_t>& street_number,
                      std::optional<std::string>& street_name) const
-  {
-    if(this->identifier == identifier)
-    {
-      street_number.reset();
-      street_name.reset();
-      if(type != shortjson::Field::String)
-        throw line_number;
-      auto val = toString();
-      try
-      {
-        auto pos = std::find_if(std::begin(val), std::end(val),
-                       [](unsigned char c){ return std::isspace(c); });
-        street_number = ext::from_string<int32_t>(std::string(std::begin(val), pos));
-        pos = std::next(pos);
-        street_name = std::string(pos, std::end(val));
-      }
-      catch(...)
-      {
-        street_name = val;
-      }
-      return bool(street_name);
-    }
-    return false;
-  }
+    { return this->identifier == identifier && asStreet<line_number>(street_number, street_name); }
 
   template<int line_number>
   bool idCoords(const std::string_view& coords_id,
@@ -437,7 +528,7 @@ struct safenode_t : shortjson::node_t
     if(this->identifier == coords_id)
     {
       value = { 0.0, 0.0 }; // reset value
-      for(const safenode_t& node : safeObject<line_number>())
+      for(const safenode_ref& node : safeObject<line_number>())
       {
         node.idFloat<line_number>(latitude_id, value.latitude) ||
         node.idFloat<line_number>(longitude_id, value.longitude);
@@ -474,33 +565,32 @@ struct safenode_t : shortjson::node_t
   }
 
   template<int line_number>
-  std::vector<safenode_t> safeObject(void) const
+  safenode_view_t safeObject(void) const
   {
-    std::vector<safenode_t> vec;
     if(type == shortjson::Field::Object)
-    {
-      for(auto node : std::get<std::vector<node_t>>(data))
-        vec.emplace_back(node);
-    }
+      return safenode_view_t(std::get<std::vector<shortjson::node_t>>(m_node.data));
     else if(type != shortjson::Field::Null)
       throw line_number;
-    return vec;
+    return safenode_view_t();
   }
 
   template<int line_number>
-  std::vector<safenode_t> safeArray(void) const
+  safenode_view_t safeArray(void) const
   {
-    std::vector<safenode_t> vec;
     if(type == shortjson::Field::Array)
-    {
-      for(auto node : std::get<std::vector<node_t>>(data))
-        vec.emplace_back(node);
-    }
+      return safenode_view_t(std::get<std::vector<shortjson::node_t>>(m_node.data));
     else if(type != shortjson::Field::Null)
       throw line_number;
-    return vec;
+    return safenode_view_t();
   }
 
+#define asString    asString<__LINE__>
+#define asBool      asBool<__LINE__>
+#define asInteger   asInteger<__LINE__>
+#define asEnum      asEnum<__LINE__>
+#define asFloat     asFloat<__LINE__>
+#define asFloatUnit asFloatUnit<__LINE__>
+#define asStreet    asStreet<__LINE__>
 #define idString    idString<__LINE__>
 #define idBool      idBool<__LINE__>
 #define idInteger   idInteger<__LINE__>
@@ -513,6 +603,34 @@ struct safenode_t : shortjson::node_t
 #define idArray     idArray<__LINE__>
 #define safeObject  safeObject<__LINE__>
 #define safeArray   safeArray<__LINE__>
+
+private:
+  const shortjson::node_t& m_node;
+};
+
+inline safenode_ref safenode_view_t::iterator::operator *(void) const noexcept
+  { return safenode_ref(*m_pos); }
+
+inline safenode_ref safenode_view_t::front(void) const noexcept
+  { return *begin(); }
+
+// holds the tree the accessors walk, constructed before the safenode_ref that refers to it
+struct safenode_tree_t
+{
+  shortjson::node_t tree;
+};
+
+// the root of a parsed tree, child nodes are reached through safenode_ref
+struct safenode_t : private safenode_tree_t, public safenode_ref
+{
+  safenode_t(shortjson::node_t&& other) // takes over a freshly parsed tree
+    : safenode_tree_t{ std::move(other) }, safenode_ref(tree) { }
+  safenode_t(const shortjson::node_t& other)
+    : safenode_tree_t{ other }, safenode_ref(tree) { }
+  safenode_t(const safenode_t& other)
+    : safenode_tree_t{ other.tree }, safenode_ref(tree) { }
+  safenode_t(safenode_t&& other) noexcept
+    : safenode_tree_t{ std::move(other.tree) }, safenode_ref(tree) { }
 };
 
 
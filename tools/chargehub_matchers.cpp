@@ -0,0 +1,198 @@
+// checks the hand-rolled chargehub matchers against the std::regex patterns they replaced
+// usage: chargehub_matchers [inputs] [seed]
+
+#include <iostream>
+#include <regex>
+#include <random>
+#include <vector>
+#include <utility>
+
+#include <cstdlib>
+
+#include <scrapers/chargehub_matchers.h>
+
+constexpr std::string_view hours_pattern = "(closed|([[:digit:]]{1,2}:[[:digit:]]{2})[[:space:]]?[~-][[:space:]]?([[:digit:]]{1,2}:[[:digit:]]{2}))";
+
+constexpr std::array<std::size_t, 4> day_lengths = { std::string::npos, 3, 2, 1 };
+
+// pieces of price and schedule strings, near misses included
+constexpr std::array<std::string_view, 7> spaces = { "", " ", " ", "  ", "\t", ":", ": " };
+constexpr std::array<std::string_view, 6> separators = { "-", "-", "~", "/", ",", "" };
+constexpr std::array<std::string_view, 8> times = { "9:00", "09:30", "23:59", "0:00", "123:45", "1:5", "12:", "12" };
+constexpr std::array<std::string_view, 8> units = { "kWh", "hr", "min", "kwh", "kWhx", "h", "", "mins" };
+constexpr std::array<std::string_view, 7> noise = { " ", ",", ".", "$", "closed", "close", "24 hours" };
+
+class input_generator
+{
+public:
+  input_generator(unsigned int seed) : m_generator(seed) { }
+
+  std::string operator()(void)
+  {
+    switch(pick(3))
+    {
+      case 0: return price();
+      case 1: return schedule();
+    }
+    std::string input;
+    for(std::size_t i = 1 + pick(6); i; --i)
+      input.append(pick(2) ? schedule() : price());
+    return input;
+  }
+
+private:
+  std::size_t pick(std::size_t count) { return std::uniform_int_distribution<std::size_t>(0, count - 1)(m_generator); }
+
+  template<typename T>
+  std::string_view any(const T& values) { return values.at(pick(values.size())); }
+
+  std::string digits(std::size_t max)
+  {
+    std::string value;
+    for(std::size_t i = pick(max + 1); i; --i)
+      value.push_back(char('0' + pick(10)));
+    return value;
+  }
+
+  // $x.xx / unit
+  std::string price(void)
+  {
+    std::string input = pick(8) ? "$" : "";
+    input.append(digits(3));
+    if(pick(8))
+      input.push_back('.');
+    input.append(digits(3));
+    input.append(any(spaces));
+    input.append(pick(8) ? "/" : any(separators));
+    input.append(any(spaces));
+    input.append(any(units));
+    return input;
+  }
+
+  // day names whole or cut, joined by lists or ranges, followed by hours
+  std::string schedule(void)
+  {
+    std::string input;
+    for(std::size_t i = 1 + pick(3); i; --i)
+    {
+      std::string_view name = day_name_data.at(pick(2)).at(pick(7));
+      input.append(name.substr(0, pick(2) ? name.size() : 1 + pick(3)));
+      input.append(any(spaces));
+      if(!pick(3))
+        input.append(any(separators)).append(any(spaces));
+    }
+    if(pick(4))
+      input.append(any(times)).append(any(spaces)).append(any(separators)).append(any(spaces)).append(any(times));
+    else
+      input.append(any(noise));
+    if(!pick(4))
+      input.append(any(noise));
+    return input;
+  }
+
+  std::mt19937 m_generator;
+};
+
+std::regex day_regex(std::string_view pattern, Language lang, std::size_t length)
+{
+  std::string days;
+  for(const std::string_view& name : day_name_data[lang])
+  {
+    if(!days.empty())
+      days.push_back('|');
+    days.append(name.substr(0, length));
+  }
+
+  std::string expression(pattern);
+  for(std::size_t pos; (pos = expression.find("%0")) != std::string::npos;)
+    expression.replace(pos, 2, "(" + days + ")");
+  for(std::size_t pos; (pos = expression.find("%1")) != std::string::npos;)
+    expression.replace(pos, 2, hours_pattern);
+  return std::regex(expression, std::regex_constants::extended);
+}
+
+bool same_group(const std::ssub_match& group, std::optional<std::string_view> value)
+  { return group.matched ? value && group.str() == *value : !value; }
+
+bool same_hours(const std::smatch& match, std::size_t start_time, const hours_match_t& hours)
+{
+  return same_group(match[start_time], hours.start_time) &&
+         same_group(match[start_time + 1], hours.end_time) &&
+         std::size_t(match.length(0)) == hours.length;
+}
+
+int main(int argc, char* argv[])
+{
+  const std::size_t inputs = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 100000;
+  input_generator generate(argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 1);
+
+  const std::regex unit_price("^\\$([[:digit:]]*[.][[:digit:]][[:digit:]])[[:space:]]/[[:space:]](kWh|hr|min)", std::regex_constants::extended);
+  const std::regex time("^([[:digit:]]{1,2}):([[:digit:]]{2})$", std::regex_constants::extended);
+  const std::regex daily_hours("^([[:digit:]]{1,2}:[[:digit:]]{2})[[:space:]]?[~-][[:space:]]?([[:digit:]]{1,2}:[[:digit:]]{2})$", std::regex_constants::extended);
+
+  std::vector<std::pair<Language, std::size_t>> variants;
+  std::vector<std::regex> day_ranges, day_lists;
+  for(std::size_t length : day_lengths)
+  {
+    for(Language lang : { English, French })
+    {
+      variants.emplace_back(lang, length);
+      day_ranges.push_back(day_regex("^%0[[:space:]]?-[[:space:]]?%0:?[[:space:]]%1", lang, length));
+      day_lists.push_back(day_regex("^((%0:?[[:space:]])+)%1", lang, length));
+    }
+  }
+
+  std::size_t mismatches = 0;
+  auto report = [&mismatches](std::string_view matcher, const std::string& input)
+  {
+    if(++mismatches <= 20)
+      std::cerr << matcher << " disagrees on: \"" << input << '"' << std::endl;
+  };
+
+  for(std::size_t i = 0; i < inputs; ++i)
+  {
+    const std::string input = generate();
+    std::smatch match;
+
+    std::string_view amount;
+    Unit unit;
+    bool matched = match_unit_price(input, amount, unit);
+    if(matched != std::regex_match(input, match, unit_price) ||
+       (matched && (match[1].str() != amount ||
+                    match[2].str() != (unit == Unit::KilowattHours ? "kWh" : unit == Unit::Hours ? "hr" : "min"))))
+      report("match_unit_price", input);
+
+    std::string_view text = input, value;
+    matched = scan_time(text, value) && text.empty();
+    if(matched != std::regex_search(input, match, time) ||
+       (matched && match[0].str() != value))
+      report("scan_time", input);
+
+    hours_match_t hours;
+    matched = match_daily_hours(input, hours);
+    if(matched != std::regex_search(input, match, daily_hours) ||
+       (matched && !same_hours(match, 1, hours)))
+      report("match_daily_hours", input);
+
+    for(std::size_t v = 0; v < variants.size(); ++v)
+    {
+      auto [lang, length] = variants.at(v);
+
+      matched = match_day_range(input, lang, hours, length);
+      if(matched != std::regex_search(input, match, day_ranges.at(v)) ||
+         (matched && (match[1].str() != hours.start_day ||
+                      match[2].str() != hours.end_day ||
+                      !same_hours(match, 4, hours))))
+        report("match_day_range", input);
+
+      matched = match_day_list(input, lang, hours, length);
+      if(matched != std::regex_search(input, match, day_lists.at(v)) ||
+         (matched && (match[1].str() != hours.day_list ||
+                      !same_hours(match, 5, hours))))
+        report("match_day_list", input);
+    }
+  }
+
+  std::cout << inputs << " inputs, " << mismatches << " mismatches" << std::endl;
+  return mismatches ? EXIT_FAILURE : EXIT_SUCCESS;
+}
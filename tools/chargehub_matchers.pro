@@ -0,0 +1,16 @@
+TEMPLATE = app
+CONFIG += console
+CONFIG += c++2a
+CONFIG += strict_c++
+
+CONFIG -= app_bundle
+CONFIG -= qt
+
+INCLUDEPATH += ..
+
+SOURCES += \
+        chargehub_matchers.cpp
+
+HEADERS += \
+  ../scrapers/chargehub_matchers.h \
+  ../scrapers/scraper_types.h
@@ -0,0 +1,88 @@
+// counts the heap allocations of one chargehub parse and splits them by who owns the memory:
+// the JSON tree, the records handed to the writer, and the scraper's own temporaries
+// usage: parse_allocations [tile locations]
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <cstdlib>
+#include <cstdint>
+
+#include <shortjson/shortjson.h>
+#include <scrapers/chargehub.h>
+#include "alloccounter.h"
+
+#if !defined(COUNT_ALLOCATIONS)
+#error "the counts are only kept when built with COUNT_ALLOCATIONS"
+#endif
+
+constexpr std::string_view station_details = R"({"station":{
+  "Id":"85986","LocName":"Hotel de ville","LocDesc":"Parking behind the building",
+  "StreetNo":275,"Street":"rue Notre-Dame Est","City":"Montreal","prov_state":"QC","Country":"Canada","Zip":"H2Y 1C6",
+  "Lat":45.508,"Long":-73.554,"Phone":"514-872-0311","Web":"https://montreal.ca",
+  "PriceString":"$1.00 / hr","NetworkId":3,"AccessTime":"Mon - Fri 7:00-19:00 Sat 9:00-17:00 Sun closed",
+  "AccessType":"Public","PaymentMethods":"Credit card, App",
+  "PlugsArray":[
+    {"Level":2,"Amp":"30 A","Kw":"7.2 kW","Volt":"240 V","Status":1,"Name":"J1772","PaymentMethods":"App",
+     "Ports":[{"portId":"1","displayName":"Port A"},{"portId":"2","displayName":"Port B"},
+              {"portId":"3","displayName":"Port C"},{"portId":"4","displayName":"Port D"}]},
+    {"Level":3,"Amp":"125 A","Kw":"50 kW","Volt":"400 V","Status":1,"Name":"CCS",
+     "Ports":[{"portId":"5","displayName":"Fast 1"},{"netPortId":"6","displayName":"Fast 2"}]}]}})";
+
+void measure(std::string_view name, const ChargehubScraper& scraper, const pair_data_t& data, const std::string& body)
+{
+  uint64_t start = allocation_count();
+  {
+    shortjson::node_t tree = shortjson::Parse(body);
+  }
+  const uint64_t tree = allocation_count() - start;
+
+  start = allocation_count();
+  std::vector<pair_data_t> results = scraper.Parse(data, body);
+  const uint64_t total = allocation_count() - start;
+
+  start = allocation_count();
+  {
+    std::vector<pair_data_t> copy = results; // allocates once for every block the records own
+  }
+  const uint64_t kept = allocation_count() - start;
+
+  std::cout << name << ": " << results.size() << " records, " << total << " allocations" << std::endl
+            << "  JSON tree:              " << tree << std::endl
+            << "  kept by the records:    " << kept << std::endl
+            << "  scraper temporaries:    " << int64_t(total - tree - kept) << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+  const std::size_t locations = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 4000;
+  ChargehubScraper scraper;
+
+  std::string tile = "[";
+  for(std::size_t i = 0; i < locations; ++i)
+  {
+    if(i)
+      tile.push_back(',');
+    tile.append("{\"LocID\":\"").append(std::to_string(100000 + i))
+        .append("\",\"Lat\":45.").append(std::to_string(i))
+        .append(",\"Long\":-73.").append(std::to_string(i))
+        .append(",\"NetworkId\":3}");
+  }
+  tile.push_back(']');
+
+  pair_data_t map;
+  map.query.parser = Parser::MapArea;
+  map.query.node_id = "tile0";
+  map.query.bounds = { { 45.0, 46.0 }, { -74.0, -73.0 } };
+  map.station.network_id = Network::ChargeHub;
+  measure("map tile", scraper, map, tile);
+
+  pair_data_t station;
+  station.query.parser = Parser::Station;
+  station.query.node_id = "85986";
+  station.station.network_id = Network::ChargeHub;
+  measure("station details", scraper, station, std::string(station_details));
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,34 @@
+TEMPLATE = app
+CONFIG += console
+CONFIG += c++2a
+CONFIG += strict_c++
+CONFIG += rtti_off
+
+CONFIG -= app_bundle
+CONFIG -= qt
+
+DEFINES += COUNT_ALLOCATIONS
+
+INCLUDEPATH += ..
+
+SOURCES += \
+        parse_allocations.cpp \
+        ../alloccounter.cpp \
+        ../scrapers/chargehub.cpp \
+        ../scrapers/scraper_types.cpp \
+        ../scrapers/utilities.cpp \
+        ../scrapers/scraper_base.cpp \
+        ../shortjson/shortjson_tolerant.cpp \
+        ../tinf/src/adler32.c \
+        ../tinf/src/crc32.c \
+        ../tinf/src/tinfgzip.c \
+        ../tinf/src/tinflate.c \
+        ../tinf/src/tinfzlib.c
+
+HEADERS += \
+  ../alloccounter.h \
+  ../scrapers/chargehub.h \
+  ../scrapers/scraper_types.h \
+  ../scrapers/utilities.h \
+  ../scrapers/scraper_base.h \
+  ../shortjson/shortjson.h
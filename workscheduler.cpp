@@ -0,0 +1,114 @@
+#include "workscheduler.h"
+
+// STL
+#include <algorithm>
+#include <utility>
+
+std::optional<schedule_policy_t> to_schedule_policy(std::string_view name) noexcept
+{
+  if(name == "fifo")
+    return schedule_policy_t::fifo;
+  if(name == "kind")
+    return schedule_policy_t::kind;
+  if(name == "depth")
+    return schedule_policy_t::depth;
+  if(name == "locality")
+    return schedule_policy_t::locality;
+  return {};
+}
+
+// spreads the low 32 bits of value over the even bits of the result
+static uint64_t interleave(uint64_t value) noexcept
+{
+  value &= 0x00000000FFFFFFFF;
+  value = (value | (value << 16)) & 0x0000FFFF0000FFFF;
+  value = (value | (value <<  8)) & 0x00FF00FF00FF00FF;
+  value = (value | (value <<  4)) & 0x0F0F0F0F0F0F0F0F;
+  value = (value | (value <<  2)) & 0x3333333333333333;
+  value = (value | (value <<  1)) & 0x5555555555555555;
+  return value;
+}
+
+WorkScheduler::WorkScheduler(schedule_policy_t policy)
+  : m_policy(policy)
+{
+}
+
+// heap order: smallest key first, oldest first among equal keys
+bool WorkScheduler::later(const located_t& a, const located_t& b) noexcept
+{
+  return a.key != b.key ? a.key > b.key : a.sequence > b.sequence;
+}
+
+std::size_t WorkScheduler::rank(const pair_data_t& data) noexcept
+{
+  switch(Parser(uint8_t(data.query.parser) & 0x0F)) // the same for queries still to be built
+  {
+    case Parser::Port:    return 0;
+    case Parser::Station: return 1;
+    default:              return 2;
+  }
+}
+
+// records without bounds (stations, the initial query) come before every map area
+uint64_t WorkScheduler::locality_key(const pair_data_t& data) noexcept
+{
+  if(!data.query.bounds)
+    return 0;
+  coords_t focus = data.query.bounds.getFocus();
+  auto quantize = [](double value, double range) -> uint64_t
+    { return uint64_t(std::clamp((value + range) / (2 * range), 0.0, 1.0) * double(0xFFFFFFFE)) + 1; };
+  return (interleave(quantize(focus.latitude, 90.0)) << 1) | interleave(quantize(focus.longitude, 180.0));
+}
+
+void WorkScheduler::push(pair_data_t&& data)
+{
+  switch(m_policy)
+  {
+    case schedule_policy_t::fifo:
+      m_ranked[0].push_back(std::move(data));
+      break;
+    case schedule_policy_t::kind:
+      m_ranked[rank(data)].push_back(std::move(data));
+      break;
+    case schedule_policy_t::depth:
+      m_stack.push_back(std::move(data));
+      break;
+    case schedule_policy_t::locality:
+    {
+      uint64_t key = locality_key(data);
+      m_heap.push_back({ key, m_sequence++, std::move(data) });
+      std::push_heap(m_heap.begin(), m_heap.end(), later);
+      break;
+    }
+  }
+  m_peak = std::max(m_peak, ++m_size);
+}
+
+pair_data_t WorkScheduler::take(void)
+{
+  --m_size;
+  switch(m_policy)
+  {
+    case schedule_policy_t::fifo:
+    case schedule_policy_t::kind:
+      for(auto& queue : m_ranked)
+        if(!queue.empty())
+          return queue.take_front();
+      break;
+    case schedule_policy_t::depth:
+    {
+      pair_data_t data = std::move(m_stack.back());
+      m_stack.pop_back();
+      return data;
+    }
+    case schedule_policy_t::locality:
+    {
+      std::pop_heap(m_heap.begin(), m_heap.end(), later);
+      pair_data_t data = std::move(m_heap.back().data);
+      m_heap.pop_back();
+      return data;
+    }
+  }
+  throw __LINE__; // taken from an empty scheduler
+}
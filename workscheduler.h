@@ -0,0 +1,61 @@
+#ifndef WORKSCHEDULER_H
+#define WORKSCHEDULER_H
+
+#include <string_view>
+#include <optional>
+#include <vector>
+#include <array>
+
+#include <cstdint>
+
+#include <scrapers/scraper_types.h>
+
+#include "ringqueue.h"
+
+enum class schedule_policy_t : uint8_t
+{
+  fifo,     // discovery order, the whole map is listed before most stations are fetched
+  kind,     // ports, then stations, then everything else, so finished stations reach the database early
+  depth,    // newest first, one map area is drilled down to its stations before its siblings are opened
+  locality, // Z-order of the area's centre, neighbouring requests are fetched together
+};
+
+std::optional<schedule_policy_t> to_schedule_policy(std::string_view name) noexcept;
+
+// the records waiting to be fetched, handed out in the order the policy picks
+// not thread safe, the crawler guards it with its queue mutex
+class WorkScheduler
+{
+public:
+  WorkScheduler(schedule_policy_t policy = schedule_policy_t::fifo);
+
+  void push(pair_data_t&& data);
+  pair_data_t take(void); // must not be empty
+
+  bool empty(void) const noexcept { return !m_size; }
+  std::size_t size(void) const noexcept { return m_size; }
+  std::size_t peak(void) const noexcept { return m_peak; } // most records ever waiting at once
+  schedule_policy_t policy(void) const noexcept { return m_policy; }
+
+private:
+  struct located_t
+  {
+    uint64_t key;
+    uint64_t sequence; // keeps equal keys in discovery order
+    pair_data_t data;
+  };
+
+  static bool later(const located_t& a, const located_t& b) noexcept;
+  static std::size_t rank(const pair_data_t& data) noexcept;
+  static uint64_t locality_key(const pair_data_t& data) noexcept;
+
+  schedule_policy_t m_policy;
+  std::array<ring_queue<pair_data_t>, 3> m_ranked; // fifo uses the first, kind one per rank
+  std::vector<pair_data_t> m_stack; // depth
+  std::vector<located_t> m_heap; // locality
+  uint64_t m_sequence = 0;
+  std::size_t m_size = 0;
+  std::size_t m_peak = 0;
+};
+
+#endif // WORKSCHEDULER_H